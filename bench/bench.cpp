@@ -0,0 +1,438 @@
+// Throughput benchmark for the CCC classifier, without R.
+//
+// Generates a synthetic discharge table, column by column like the matrices
+// ccc_mat_rcpp reads, and times each stage of ccc_mat_rcpp on it.  Results are
+// printed and, with --output, appended to a csv file so that runs can be
+// compared across releases.  See bench/README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/resource.h>
+#include "pccc.h"
+#include "packed_keys.h"
+#include "task_group.h"
+
+struct bench_options {
+  std::size_t rows = 1000000;
+  std::size_t dx_cols = 10;
+  std::size_t pc_cols = 10;
+  int icdv = 10;
+  double hit_rate = 0.05;       // share of codes drawn from the CCC code lists
+  double empty_rate = 0.6;      // share of cells which are empty (NA)
+  double other_version = 0.1;   // share of other codes taken from the other ICD version
+  std::size_t distinct = 20000; // distinct codes of each type
+  int threads = 1;
+  int reps = 3;
+  unsigned seed = 42;
+  std::string label = "default";
+  std::string output;
+};
+
+static void usage()
+{
+  std::fprintf(stderr,
+    "usage: pccc_bench [--rows N] [--dx N] [--pc N] [--icdv 9|10] [--hit-rate P]\n"
+    "                  [--empty-rate P] [--other-version P] [--distinct N]\n"
+    "                  [--threads N] [--reps N] [--seed N] [--label S] [--output FILE]\n");
+  std::exit(2);
+}
+
+static bench_options parse_options(int argc, char** argv)
+{
+  bench_options o;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      usage();
+    }
+    const char* v = argv[++i];
+    if (arg == "--rows") o.rows = std::strtoull(v, nullptr, 10);
+    else if (arg == "--dx") o.dx_cols = std::strtoull(v, nullptr, 10);
+    else if (arg == "--pc") o.pc_cols = std::strtoull(v, nullptr, 10);
+    else if (arg == "--icdv") o.icdv = std::atoi(v);
+    else if (arg == "--hit-rate") o.hit_rate = std::atof(v);
+    else if (arg == "--empty-rate") o.empty_rate = std::atof(v);
+    else if (arg == "--other-version") o.other_version = std::atof(v);
+    else if (arg == "--distinct") o.distinct = std::strtoull(v, nullptr, 10);
+    else if (arg == "--threads") o.threads = std::atoi(v);
+    else if (arg == "--reps") o.reps = std::atoi(v);
+    else if (arg == "--seed") o.seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    else if (arg == "--label") o.label = v;
+    else if (arg == "--output") o.output = v;
+    else usage();
+  }
+  if (o.rows == 0 || o.distinct == 0 || o.threads < 1 || o.reps < 1) {
+    usage();
+  }
+  return o;
+}
+
+// A random code which looks like an ICD code of the given version and type
+// but is in none of the CCC code lists.
+static std::string random_code(const codes& cdv, bool pc, std::mt19937& rng)
+{
+  static const char alnum[] = "0123456789ABCDEFGHJKLMNPQRSTUVWXYZ";
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::uniform_int_distribution<int> letter(0, 25);
+  std::uniform_int_distribution<int> any(0, sizeof alnum - 2);
+
+  while (true) {
+    std::string code;
+    if (cdv.get_version() == 9) {
+      int len = pc ? 3 + digit(rng) % 2 : 3 + digit(rng) % 3;
+      for (int i = 0; i < len; ++i) {
+        code.push_back('0' + digit(rng));
+      }
+    } else if (pc) {
+      for (int i = 0; i < 7; ++i) {
+        code.push_back(alnum[any(rng)]);
+      }
+    } else {
+      code.push_back('A' + letter(rng));
+      int len = 2 + digit(rng) % 5;
+      for (int i = 0; i < len; ++i) {
+        code.push_back(i == 2 ? alnum[any(rng)] : '0' + digit(rng));
+      }
+    }
+    if ((pc ? cdv.match_pc(code) : cdv.match_dx(code)) == 0) {
+      return code;
+    }
+  }
+}
+
+// A code in one of the CCC code lists of the given type: a list entry, with
+// prefix entries padded out to the length of a full code.
+static std::string list_code(const codes& cdv, bool pc, std::mt19937& rng)
+{
+  const std::vector<code_rule>& rules = cdv.get_rules();
+  std::uniform_int_distribution<std::size_t> pick(0, rules.size() - 1);
+  std::uniform_int_distribution<int> digit(0, 9);
+
+  while (true) {
+    const code_rule& r = rules[pick(rng)];
+    if (r.pc != pc) {
+      continue;
+    }
+    std::string code(r.code);
+    const std::size_t full = cdv.get_version() == 9 ? (pc ? 4 : 5) : (pc ? 7 : 5);
+    while (!r.fixed && code.size() < full) {
+      code.push_back('0' + digit(rng));
+    }
+    return code;
+  }
+}
+
+// The distinct codes of one type.  Cells point into the pool, as the cells of
+// an R character matrix point into R's cache of strings.
+struct code_pool {
+  std::vector<std::string> hits;
+  std::vector<std::string> misses;
+};
+
+static code_pool make_pool(const codes& cdv, const codes& other, bool pc,
+                           const bench_options& o, std::mt19937& rng)
+{
+  code_pool pool;
+  std::bernoulli_distribution from_other(o.other_version);
+  const std::size_t n_hits = std::max<std::size_t>(1, o.distinct * o.hit_rate);
+  for (std::size_t i = 0; i < n_hits; ++i) {
+    pool.hits.push_back(list_code(cdv, pc, rng));
+  }
+  for (std::size_t i = n_hits; i < o.distinct || pool.misses.empty(); ++i) {
+    std::string code = from_other(rng) ? list_code(other, pc, rng) : random_code(cdv, pc, rng);
+    if ((pc ? cdv.match_pc(code) : cdv.match_dx(code)) != 0) {
+      pool.hits.push_back(code);
+    } else {
+      pool.misses.push_back(code);
+    }
+  }
+  return pool;
+}
+
+// One column-major matrix of cells, nullptr for NA.
+static std::vector<const std::string*> make_cells(const code_pool& pool, std::size_t rows,
+                                                  std::size_t cols, const bench_options& o,
+                                                  std::mt19937& rng)
+{
+  std::vector<const std::string*> cells(rows * cols);
+  std::bernoulli_distribution empty(o.empty_rate);
+  std::bernoulli_distribution hit(o.hit_rate);
+  std::uniform_int_distribution<std::size_t> pick_hit(0, pool.hits.size() - 1);
+  std::uniform_int_distribution<std::size_t> pick_miss(0, pool.misses.size() - 1);
+
+  for (std::size_t j = 0; j < cols; ++j) {
+    for (std::size_t i = 0; i < rows; ++i) {
+      // codes are filled from the first column, as in discharge records
+      const bool na = j > 0 && (cells[(j - 1) * rows + i] == nullptr || empty(rng));
+      if (na) {
+        cells[j * rows + i] = nullptr;
+      } else if (hit(rng)) {
+        cells[j * rows + i] = &pool.hits[pick_hit(rng)];
+      } else {
+        cells[j * rows + i] = &pool.misses[pick_miss(rng)];
+      }
+    }
+  }
+  return cells;
+}
+
+static void fill_views(std::vector<std::string_view>& views,
+                       const std::vector<const std::string*>& cells)
+{
+  views.resize(cells.size());
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    views[i] = cells[i] ? std::string_view(*cells[i]) : std::string_view();
+  }
+}
+
+// Classify rows [begin, end) as codes::classify_columns does, skipping empty
+// cells and codes whose row already has every category they could add, but
+// looking each code up with match(code, pc, found).  For timing other ways
+// of matching codes against the code lists.
+template <typename Match>
+static void classify_rows(const codes& cdv, const std::string_view* dx, std::size_t dx_ncol,
+                          const std::string_view* pc, std::size_t pc_ncol, std::size_t stride,
+                          std::size_t begin, std::size_t end, uint16_t* masks, Match match)
+{
+  const uint16_t reachable[2] = {cdv.dx_reachable(), cdv.pc_reachable()};
+  for (int type = 0; type < 2; ++type) {
+    const std::string_view* cells = type ? pc : dx;
+    const std::size_t ncol = type ? pc_ncol : dx_ncol;
+    for (std::size_t j = 0; j < ncol; ++j) {
+      const std::string_view* col = cells + j * stride;
+      for (std::size_t i = begin; i < end; ++i) {
+        if (!col[i].empty() && (reachable[type] & ~masks[i])) {
+          masks[i] |= match(col[i], type == 1, masks[i]);
+        }
+      }
+    }
+  }
+}
+
+// The entries of the code lists by type and category, compared with each
+// code one at a time, as the classifier did before the code trie.
+struct compare_lists {
+  std::vector<std::string_view> prefix[2][CCC_FLAG];
+  std::vector<std::string_view> fixed[2][CCC_FLAG];
+
+  explicit compare_lists(const codes& cdv) {
+    for (const code_rule& r : cdv.get_rules()) {
+      (r.fixed ? fixed : prefix)[r.pc][r.category].push_back(r.code);
+    }
+  };
+
+  uint16_t match(std::string_view code, bool pc, uint16_t found) const {
+    uint16_t mask = 0;
+    for (int b = 0; b < CCC_FLAG; ++b) {
+      if ((found >> b) & 1) {
+        continue;
+      }
+      bool hit = false;
+      for (std::string_view entry : prefix[pc][b]) {
+        if (code.compare(0, entry.size(), entry) == 0) {
+          hit = true;
+          break;
+        }
+      }
+      for (std::size_t k = 0; !hit && k < fixed[pc][b].size(); ++k) {
+        hit = code == fixed[pc][b][k];
+      }
+      if (hit) {
+        mask |= 1 << b;
+      }
+    }
+    return mask;
+  };
+};
+
+static double peak_rss_mb()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+  return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+// Best time, in seconds, of reps runs of fn.
+static double time_best(int reps, const std::function<void()>& fn)
+{
+  double best = 0;
+  for (int r = 0; r < reps; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (r == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+static const char* csv_header =
+  "label,stage,icdv,rows,dx_cols,pc_cols,hit_rate,empty_rate,other_version,distinct,"
+  "threads,seconds,rows_per_sec,ns_per_code,peak_rss_mb\n";
+
+int main(int argc, char** argv)
+{
+  const bench_options o = parse_options(argc, argv);
+  const codes& cdv = codes::get(o.icdv);
+  const codes& other = codes::get(o.icdv == 9 ? 10 : 9);
+  std::mt19937 rng(o.seed);
+
+  const code_pool dx_pool = make_pool(cdv, other, false, o, rng);
+  const code_pool pc_pool = make_pool(cdv, other, true, o, rng);
+  const std::vector<const std::string*> dx_cells = make_cells(dx_pool, o.rows, o.dx_cols, o, rng);
+  const std::vector<const std::string*> pc_cells = make_cells(pc_pool, o.rows, o.pc_cols, o, rng);
+
+  std::size_t n_codes = 0;
+  for (const std::string* c : dx_cells) n_codes += c != nullptr;
+  for (const std::string* c : pc_cells) n_codes += c != nullptr;
+
+  const std::size_t n = o.rows;
+  std::vector<std::string_view> dx;
+  std::vector<std::string_view> pc;
+  std::vector<uint16_t> masks(n);
+  std::vector<int> out(n * (CCC_FLAG + 1));
+  std::vector<int> where(n * CCC_FLAG);
+  std::vector<int> rule(n * CCC_FLAG);
+
+  const compare_lists lists(cdv);
+  const packed_list packed[2] = {packed_list(cdv.get_rules(), false), packed_list(cdv.get_rules(), true)};
+  const packed_list plain[2] = {packed_list(cdv.get_rules(), false, false),
+                                packed_list(cdv.get_rules(), true, false)};
+
+  struct stage {
+    const char* name;
+    std::function<void()> fn;
+  };
+
+  const std::vector<stage> stages = {
+    // the copy of the cells into string_views done by the main thread
+    {"views", [&]() {
+      fill_views(dx, dx_cells);
+      fill_views(pc, pc_cells);
+    }},
+    {"classify", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        cdv.classify_columns(dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end, masks.data());
+      });
+    }},
+    {"classify_memo", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        mask_memo dx_memo;
+        mask_memo pc_memo;
+        cdv.classify_columns(dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end,
+                             masks.data(), dx_memo, pc_memo);
+      });
+    }},
+    {"explain", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        cdv.explain_columns(dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end,
+                            masks.data(), where.data(), rule.data(), n);
+      });
+    }},
+    // other ways of matching the codes, for comparison with classify
+    {"compare", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        classify_rows(cdv, dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end, masks.data(),
+                      [&lists](std::string_view code, bool pc, uint16_t found) {
+                        return lists.match(code, pc, found);
+                      });
+      });
+    }},
+    {"packed", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        classify_rows(cdv, dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end, masks.data(),
+                      [&packed](std::string_view code, bool pc, uint16_t found) {
+                        return packed[pc].match(code, found);
+                      });
+      });
+    }},
+    {"packed_scalar", [&]() {
+      std::fill(masks.begin(), masks.end(), 0);
+      parallel_for(n, o.threads, [&](std::size_t begin, std::size_t end) {
+        classify_rows(cdv, dx.data(), o.dx_cols, pc.data(), o.pc_cols, n, begin, end, masks.data(),
+                      [&plain](std::string_view code, bool pc, uint16_t found) {
+                        return plain[pc].match(code, found);
+                      });
+      });
+    }},
+    // the write of the masks into the 13 integer columns of the result
+    {"expand", [&]() {
+      for (int j = 0; j <= CCC_FLAG; ++j) {
+        int* col = out.data() + j * n;
+        for (std::size_t i = 0; i < n; ++i) {
+          col[i] = ((masks[i] | (masks[i] ? 1 << CCC_FLAG : 0)) >> j) & 1;
+        }
+      }
+    }},
+  };
+
+  std::FILE* csv = nullptr;
+  if (!o.output.empty()) {
+    const bool exists = std::ifstream(o.output).good();
+    csv = std::fopen(o.output.c_str(), "a");
+    if (!csv) {
+      std::fprintf(stderr, "Unable to open '%s' for writing.\n", o.output.c_str());
+      return 1;
+    }
+    if (!exists) {
+      std::fputs(csv_header, csv);
+    }
+  }
+
+  std::printf("icdv %d, %zu rows, %zu dx and %zu pc columns, %zu codes, %d thread(s), %s packed keys\n",
+              o.icdv, n, o.dx_cols, o.pc_cols, n_codes, o.threads, packed[0].kernel_name());
+  std::printf("%-14s %10s %14s %10s %12s\n", "stage", "seconds", "rows/sec", "ns/code", "peak RSS MB");
+
+  double total = 0;
+  for (const stage& s : stages) {
+    const double seconds = time_best(o.reps, s.fn);
+    // the stages which ccc_mat_rcpp runs by default
+    if (std::strcmp(s.name, "views") == 0 || std::strcmp(s.name, "classify_memo") == 0 ||
+        std::strcmp(s.name, "expand") == 0) {
+      total += seconds;
+    }
+
+    const double rows_per_sec = n / seconds;
+    const double ns_per_code = n_codes ? seconds * 1e9 / n_codes : 0;
+    const double rss = peak_rss_mb();
+    std::printf("%-14s %10.4f %14.0f %10.2f %12.1f\n", s.name, seconds, rows_per_sec, ns_per_code, rss);
+    if (csv) {
+      std::fprintf(csv, "%s,%s,%d,%zu,%zu,%zu,%g,%g,%g,%zu,%d,%.6f,%.0f,%.3f,%.1f\n",
+                   o.label.c_str(), s.name, o.icdv, n, o.dx_cols, o.pc_cols, o.hit_rate,
+                   o.empty_rate, o.other_version, o.distinct, o.threads, seconds,
+                   rows_per_sec, ns_per_code, rss);
+    }
+  }
+
+  const double rss = peak_rss_mb();
+  std::printf("%-14s %10.4f %14.0f %10.2f %12.1f\n", "total", total, n / total,
+              n_codes ? total * 1e9 / n_codes : 0, rss);
+  if (csv) {
+    std::fprintf(csv, "%s,%s,%d,%zu,%zu,%zu,%g,%g,%g,%zu,%d,%.6f,%.0f,%.3f,%.1f\n",
+                 o.label.c_str(), "total", o.icdv, n, o.dx_cols, o.pc_cols, o.hit_rate,
+                 o.empty_rate, o.other_version, o.distinct, o.threads, total,
+                 n / total, n_codes ? total * 1e9 / n_codes : 0, rss);
+    std::fclose(csv);
+  }
+
+  return 0;
+}
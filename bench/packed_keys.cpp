@@ -0,0 +1,90 @@
+#include <stdexcept>
+#include <string>
+#include "packed_keys.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PACKED_KEYS_AVX2
+#include <immintrin.h>
+#endif
+
+static bool any_match_scalar(const uint64_t* keys, const uint64_t* masks, std::size_t n,
+                             uint64_t code)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    if ((code & masks[i]) == keys[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef PACKED_KEYS_AVX2
+// Compiled for AVX2 whatever the flags of the rest of the build, and only
+// called once the CPU has been checked for it.
+__attribute__((target("avx2")))
+static bool any_match_avx2(const uint64_t* keys, const uint64_t* masks, std::size_t n,
+                           uint64_t code)
+{
+  const __m256i c = _mm256_set1_epi64x(static_cast<long long>(code));
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i));
+    const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+    const __m256i eq = _mm256_cmpeq_epi64(_mm256_and_si256(c, m), k);
+    if (!_mm256_testz_si256(eq, eq)) {
+      return true;
+    }
+  }
+  return any_match_scalar(keys + i, masks + i, n - i, code);
+}
+#endif
+
+packed_list::packed_list(const std::vector<code_rule>& rules, bool pc, bool simd)
+  : any_match(any_match_scalar), kernel("scalar")
+{
+#ifdef PACKED_KEYS_AVX2
+  if (simd && __builtin_cpu_supports("avx2")) {
+    any_match = any_match_avx2;
+    kernel = "avx2";
+  }
+#endif
+
+  for (int b = 0; b <= CCC_FLAG; ++b) {
+    first[b] = 0;
+  }
+  for (const code_rule& r : rules) {
+    if (r.pc == pc) {
+      ++first[r.category + 1];
+    }
+  }
+  for (int b = 0; b < CCC_FLAG; ++b) {
+    first[b + 1] += first[b];
+  }
+
+  keys.resize(first[CCC_FLAG]);
+  masks.resize(first[CCC_FLAG]);
+  std::size_t next[CCC_FLAG];
+  for (int b = 0; b < CCC_FLAG; ++b) {
+    next[b] = first[b];
+  }
+
+  for (const code_rule& r : rules) {
+    if (r.pc != pc) {
+      continue;
+    }
+    if (r.code.size() > 7) {
+      throw std::invalid_argument("ICD code '" + std::string(r.code) + "' is too long for a packed key.");
+    }
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < r.code.size(); ++i) {
+      mask |= UINT64_C(0xFF) << (56 - 8 * i);
+    }
+    if (r.fixed) {
+      mask |= 0xFF;
+    }
+    const uint64_t packed = pack_code(r.code);
+    const std::size_t at = next[r.category]++;
+    keys[at] = packed & mask;
+    masks[at] = mask;
+  }
+}
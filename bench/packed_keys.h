@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "pccc.h"
+
+#ifndef PACKED_KEYS_H
+#define PACKED_KEYS_H
+
+// A code packed into one 64-bit word: up to seven characters in the high
+// bytes, the first character highest, and the length in the low byte.  Codes
+// longer than seven characters keep their first seven and a length of 255, so
+// that they can still match prefix entries but never fixed ones.
+inline uint64_t pack_code(std::string_view code)
+{
+  const std::size_t n = code.size() < 7 ? code.size() : 7;
+  uint64_t key = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    key |= static_cast<uint64_t>(static_cast<unsigned char>(code[i])) << (56 - 8 * i);
+  }
+  return key | (code.size() <= 7 ? code.size() : 255);
+}
+
+// The entries of the dx or pc code lists of a codes object as packed keys,
+// grouped by category, for matching a code against many entries at once
+// instead of walking the trie.  A code matches entry i when
+// (pack_code(code) & mask[i]) == key[i]: the mask of a prefix entry covers
+// its characters, and that of a fixed entry its characters and its length.
+// The compare loop uses AVX2, four entries at a time, when the CPU running
+// the code has it, and plain 64-bit compares otherwise.  Entries must have at
+// most seven characters.  Immutable once built, and safe to share between
+// threads.
+class packed_list {
+  public:
+    typedef bool (*kernel_fn)(const uint64_t* keys, const uint64_t* masks, std::size_t n,
+                              uint64_t code);
+
+  private:
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> masks;
+    // the entries of category b are [first[b], first[b + 1])
+    std::size_t first[CCC_FLAG + 1];
+    kernel_fn any_match;
+    const char* kernel;
+
+  public:
+    // With simd false the plain kernel is used whatever the CPU.
+    packed_list(const std::vector<code_rule>& rules, bool pc, bool simd = true);
+
+    // The categories of the entries which code matches, as code_trie::match.
+    // Categories set in found are not searched.
+    uint16_t match(std::string_view code, uint16_t found = 0) const {
+      const uint64_t packed = pack_code(code);
+      uint16_t mask = 0;
+      for (int b = 0; b < CCC_FLAG; ++b) {
+        if (!((found >> b) & 1) && first[b] < first[b + 1] &&
+            any_match(keys.data() + first[b], masks.data() + first[b],
+                      first[b + 1] - first[b], packed)) {
+          mask |= 1 << b;
+        }
+      }
+      return mask;
+    };
+
+    std::size_t size() const { return keys.size(); };
+
+    // "avx2" or "scalar"
+    const char* kernel_name() const { return kernel; };
+};
+
+#endif
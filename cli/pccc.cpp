@@ -0,0 +1,182 @@
+// pccc: classify the rows of delimited files into complex chronic conditions
+// from the command line, without R.  See cli/README.md.
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pccc.h"
+#include "delim_reader.h"
+#include "flag_output.h"
+
+struct cli_options {
+  int icdv = 0;
+  std::string id;
+  std::string dx;
+  std::string pc;
+  char delim = ',';
+  std::size_t chunk_size = 100000;
+  int threads = 1;
+  std::string output;
+  std::vector<std::string> files;
+};
+
+static void usage()
+{
+  std::fprintf(stderr,
+    "usage: pccc --icdv 9|10 [--dx COLS] [--pc COLS] [--id COL] [--delim C]\n"
+    "            [--chunk-size N] [--threads N] [--output FILE] [FILE ...]\n"
+    "\n"
+    "Reads each FILE, or standard input, and writes the id and the CCC flags of\n"
+    "each row.  COLS is a comma separated list of column names, 1-based column\n"
+    "numbers, or name prefixes ending in '*', such as dx*.\n");
+  std::exit(2);
+}
+
+static cli_options parse_options(int argc, char** argv)
+{
+  cli_options o;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.size() < 2 || arg.compare(0, 2, "--") != 0) {
+      o.files.push_back(arg);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+    }
+    std::string v = argv[++i];
+    if (arg == "--icdv") o.icdv = std::atoi(v.c_str());
+    else if (arg == "--id") o.id = v;
+    else if (arg == "--dx") o.dx = v;
+    else if (arg == "--pc") o.pc = v;
+    else if (arg == "--delim") o.delim = v == "tab" || v == "\\t" ? '\t' : v.size() == 1 ? v[0] : 0;
+    else if (arg == "--chunk-size") o.chunk_size = std::strtoull(v.c_str(), nullptr, 10);
+    else if (arg == "--threads") o.threads = std::atoi(v.c_str());
+    else if (arg == "--output") o.output = v;
+    else usage();
+  }
+  if (o.icdv == 0 || o.delim == 0 || o.chunk_size == 0 || o.threads < 1 ||
+      (o.dx.empty() && o.pc.empty())) {
+    usage();
+  }
+  if (o.files.empty()) {
+    o.files.push_back("-");
+  }
+  return o;
+}
+
+// Find the columns selected by a COLS list in the header.
+static std::vector<std::size_t> resolve_columns(const std::string& selection,
+                                                const std::vector<std::string>& header)
+{
+  std::vector<std::size_t> cols;
+  std::size_t start = 0;
+
+  while (start < selection.size()) {
+    std::size_t comma = selection.find(',', start);
+    if (comma == std::string::npos) {
+      comma = selection.size();
+    }
+    std::string item = selection.substr(start, comma - start);
+    start = comma + 1;
+    if (item.empty()) {
+      continue;
+    }
+
+    if (item.find_first_not_of("0123456789") == std::string::npos) {
+      std::size_t j = std::strtoull(item.c_str(), nullptr, 10);
+      if (j < 1 || j > header.size()) {
+        throw std::invalid_argument("Column " + item + " is not in the input file.");
+      }
+      cols.push_back(j - 1);
+    } else {
+      select_columns(item, header, cols);
+    }
+  }
+
+  return cols;
+}
+
+static void write_lines(std::FILE* out, const std::string& lines)
+{
+  if (std::fwrite(lines.data(), 1, lines.size(), out) != lines.size()) {
+    throw std::runtime_error("Error writing the output.");
+  }
+}
+
+// Writes the rows of each chunk to the output as they are classified.
+class line_sink : public row_sink {
+  private:
+    std::FILE* out;
+    const std::vector<std::size_t>& id;
+    char delim;
+    std::string lines;
+
+  public:
+    line_sink(std::FILE* out, const std::vector<std::size_t>& id, char delim)
+      : out(out), id(id), delim(delim) {};
+
+    void add_rows(const delim_chunk& chunk, const uint16_t* masks) override {
+      lines.clear();
+      append_rows(lines, chunk, masks, id, delim);
+      write_lines(out, lines);
+    };
+};
+
+// Classify one file chunk_size records at a time and write its rows to out,
+// after the header line if header is true.
+static void classify_file(const codes& cdv, const cli_options& o, const std::string& file,
+                          std::FILE* out, bool header)
+{
+  delim_reader reader(file, o.delim);
+  const std::vector<std::string> names = read_header(reader);
+  if (names.empty()) {
+    throw std::runtime_error("The input file '" + file + "' is empty.");
+  }
+
+  const std::vector<std::size_t> id = resolve_columns(o.id, names);
+  const std::vector<std::size_t> dx = resolve_columns(o.dx, names);
+  const std::vector<std::size_t> pc = resolve_columns(o.pc, names);
+  if (id.size() > 1) {
+    throw std::invalid_argument("Only one id column can be selected.");
+  }
+
+  if (header) {
+    std::string lines;
+    append_header(lines, !id.empty(), id.empty() ? std::string_view() : names[id[0]], o.delim);
+    write_lines(out, lines);
+  }
+
+  line_sink sink(out, id, o.delim);
+  classify_stream(cdv, reader, dx, pc, o.chunk_size, o.threads, sink);
+}
+
+int main(int argc, char** argv)
+{
+  const cli_options o = parse_options(argc, argv);
+  std::FILE* out = stdout;
+
+  try {
+    const codes& cdv = codes::get(o.icdv);
+    if (!o.output.empty()) {
+      out = std::fopen(o.output.c_str(), "wb");
+      if (!out) {
+        throw std::runtime_error("Unable to open '" + o.output + "' for writing.");
+      }
+    }
+    for (std::size_t f = 0; f < o.files.size(); ++f) {
+      classify_file(cdv, o, o.files[f], out, f == 0);
+    }
+    if (out != stdout && std::fclose(out) != 0) {
+      throw std::runtime_error("Error writing the output.");
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "pccc: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -11,15 +11,212 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // ccc_mat_rcpp
-Rcpp::DataFrame ccc_mat_rcpp(Rcpp::CharacterMatrix& dx, Rcpp::CharacterMatrix& pc, int version);
-RcppExport SEXP _pccc_ccc_mat_rcpp(SEXP dxSEXP, SEXP pcSEXP, SEXP versionSEXP) {
+SEXP ccc_mat_rcpp(Rcpp::CharacterMatrix& dx, Rcpp::CharacterMatrix& pc, SEXP version, int n_threads, bool memoize, std::string output, bool explain, bool stats, bool normalize);
+RcppExport SEXP _pccc_ccc_mat_rcpp(SEXP dxSEXP, SEXP pcSEXP, SEXP versionSEXP, SEXP n_threadsSEXP, SEXP memoizeSEXP, SEXP outputSEXP, SEXP explainSEXP, SEXP statsSEXP, SEXP normalizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Rcpp::CharacterMatrix& >::type dx(dxSEXP);
     Rcpp::traits::input_parameter< Rcpp::CharacterMatrix& >::type pc(pcSEXP);
-    Rcpp::traits::input_parameter< int >::type version(versionSEXP);
-    rcpp_result_gen = Rcpp::wrap(ccc_mat_rcpp(dx, pc, version));
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type memoize(memoizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< bool >::type explain(explainSEXP);
+    Rcpp::traits::input_parameter< bool >::type stats(statsSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_mat_rcpp(dx, pc, version, n_threads, memoize, output, explain, stats, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_cols_rcpp
+SEXP ccc_cols_rcpp(Rcpp::List dx, Rcpp::List pc, int nrow, SEXP version, int n_threads, bool memoize, std::string output, bool explain, bool stats, bool normalize);
+RcppExport SEXP _pccc_ccc_cols_rcpp(SEXP dxSEXP, SEXP pcSEXP, SEXP nrowSEXP, SEXP versionSEXP, SEXP n_threadsSEXP, SEXP memoizeSEXP, SEXP outputSEXP, SEXP explainSEXP, SEXP statsSEXP, SEXP normalizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type dx(dxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type pc(pcSEXP);
+    Rcpp::traits::input_parameter< int >::type nrow(nrowSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type memoize(memoizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< bool >::type explain(explainSEXP);
+    Rcpp::traits::input_parameter< bool >::type stats(statsSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_cols_rcpp(dx, pc, nrow, version, n_threads, memoize, output, explain, stats, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_factor_rcpp
+SEXP ccc_factor_rcpp(Rcpp::List dx, Rcpp::List pc, SEXP version, int n_threads, std::string output, bool normalize);
+RcppExport SEXP _pccc_ccc_factor_rcpp(SEXP dxSEXP, SEXP pcSEXP, SEXP versionSEXP, SEXP n_threadsSEXP, SEXP outputSEXP, SEXP normalizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type dx(dxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type pc(pcSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_factor_rcpp(dx, pc, version, n_threads, output, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_cached_rcpp
+SEXP ccc_cached_rcpp(SEXP id, Rcpp::List dx, Rcpp::List pc, int nrow, SEXP version, std::string cache, int n_threads, std::string output, bool normalize);
+RcppExport SEXP _pccc_ccc_cached_rcpp(SEXP idSEXP, SEXP dxSEXP, SEXP pcSEXP, SEXP nrowSEXP, SEXP versionSEXP, SEXP cacheSEXP, SEXP n_threadsSEXP, SEXP outputSEXP, SEXP normalizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type id(idSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type dx(dxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type pc(pcSEXP);
+    Rcpp::traits::input_parameter< int >::type nrow(nrowSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< std::string >::type cache(cacheSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_cached_rcpp(id, dx, pc, nrow, version, cache, n_threads, output, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_expand
+Rcpp::List ccc_expand(Rcpp::IntegerVector mask, SEXP categories);
+RcppExport SEXP _pccc_ccc_expand(SEXP maskSEXP, SEXP categoriesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type mask(maskSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type categories(categoriesSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_expand(mask, categories));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_memo_stats
+Rcpp::NumericVector ccc_memo_stats();
+RcppExport SEXP _pccc_ccc_memo_stats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(ccc_memo_stats());
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_cache_stats
+Rcpp::NumericVector ccc_cache_stats();
+RcppExport SEXP _pccc_ccc_cache_stats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(ccc_cache_stats());
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_file_rcpp
+SEXP ccc_file_rcpp(std::string file, SEXP id, SEXP dx_cols, SEXP pc_cols, SEXP version, SEXP output, SEXP callback, std::string delim, int chunk_size, int n_threads, bool mmap);
+RcppExport SEXP _pccc_ccc_file_rcpp(SEXP fileSEXP, SEXP idSEXP, SEXP dx_colsSEXP, SEXP pc_colsSEXP, SEXP versionSEXP, SEXP outputSEXP, SEXP callbackSEXP, SEXP delimSEXP, SEXP chunk_sizeSEXP, SEXP n_threadsSEXP, SEXP mmapSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type id(idSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type dx_cols(dx_colsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type pc_cols(pc_colsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type output(outputSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type callback(callbackSEXP);
+    Rcpp::traits::input_parameter< std::string >::type delim(delimSEXP);
+    Rcpp::traits::input_parameter< int >::type chunk_size(chunk_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type mmap(mmapSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_file_rcpp(file, id, dx_cols, pc_cols, version, output, callback, delim, chunk_size, n_threads, mmap));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_index_rcpp
+SEXP ccc_index_rcpp(Rcpp::IntegerVector mask, Rcpp::List dx, Rcpp::List pc, bool normalize);
+RcppExport SEXP _pccc_ccc_index_rcpp(SEXP maskSEXP, SEXP dxSEXP, SEXP pcSEXP, SEXP normalizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type mask(maskSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type dx(dxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type pc(pcSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_index_rcpp(mask, dx, pc, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_query_rcpp
+Rcpp::IntegerVector ccc_query_rcpp(SEXP index, Rcpp::CharacterVector all, Rcpp::CharacterVector any, Rcpp::CharacterVector none);
+RcppExport SEXP _pccc_ccc_query_rcpp(SEXP indexSEXP, SEXP allSEXP, SEXP anySEXP, SEXP noneSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type all(allSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type any(anySEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type none(noneSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_query_rcpp(index, all, any, none));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_index_save_rcpp
+void ccc_index_save_rcpp(SEXP index, std::string file);
+RcppExport SEXP _pccc_ccc_index_save_rcpp(SEXP indexSEXP, SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    ccc_index_save_rcpp(index, file);
+    return R_NilValue;
+END_RCPP
+}
+// ccc_index_load_rcpp
+SEXP ccc_index_load_rcpp(std::string file);
+RcppExport SEXP _pccc_ccc_index_load_rcpp(SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_index_load_rcpp(file));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_long_rcpp
+Rcpp::List ccc_long_rcpp(SEXP id, SEXP code, SEXP is_pc, SEXP version, bool sorted, bool normalize);
+RcppExport SEXP _pccc_ccc_long_rcpp(SEXP idSEXP, SEXP codeSEXP, SEXP is_pcSEXP, SEXP versionSEXP, SEXP sortedSEXP, SEXP normalizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type id(idSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type code(codeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type is_pc(is_pcSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type version(versionSEXP);
+    Rcpp::traits::input_parameter< bool >::type sorted(sortedSEXP);
+    Rcpp::traits::input_parameter< bool >::type normalize(normalizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_long_rcpp(id, code, is_pc, version, sorted, normalize));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_lookback_rcpp
+Rcpp::IntegerVector ccc_lookback_rcpp(SEXP id, Rcpp::NumericVector date, Rcpp::IntegerVector mask, double days, bool include_current, bool sorted, int n_threads);
+RcppExport SEXP _pccc_ccc_lookback_rcpp(SEXP idSEXP, SEXP dateSEXP, SEXP maskSEXP, SEXP daysSEXP, SEXP include_currentSEXP, SEXP sortedSEXP, SEXP n_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type id(idSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type date(dateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type mask(maskSEXP);
+    Rcpp::traits::input_parameter< double >::type days(daysSEXP);
+    Rcpp::traits::input_parameter< bool >::type include_current(include_currentSEXP);
+    Rcpp::traits::input_parameter< bool >::type sorted(sortedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_threads(n_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_lookback_rcpp(id, date, mask, days, include_current, sorted, n_threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -34,10 +231,50 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// ccc_rules
+Rcpp::List ccc_rules(SEXP icdv);
+RcppExport SEXP _pccc_ccc_rules(SEXP icdvSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type icdv(icdvSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_rules(icdv));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ccc_table_rcpp
+SEXP ccc_table_rcpp(Rcpp::CharacterVector type, Rcpp::CharacterVector category, Rcpp::LogicalVector fixed, Rcpp::CharacterVector code);
+RcppExport SEXP _pccc_ccc_table_rcpp(SEXP typeSEXP, SEXP categorySEXP, SEXP fixedSEXP, SEXP codeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type category(categorySEXP);
+    Rcpp::traits::input_parameter< Rcpp::LogicalVector >::type fixed(fixedSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type code(codeSEXP);
+    rcpp_result_gen = Rcpp::wrap(ccc_table_rcpp(type, category, fixed, code));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_pccc_ccc_mat_rcpp", (DL_FUNC) &_pccc_ccc_mat_rcpp, 3},
+    {"_pccc_ccc_mat_rcpp", (DL_FUNC) &_pccc_ccc_mat_rcpp, 9},
+    {"_pccc_ccc_cols_rcpp", (DL_FUNC) &_pccc_ccc_cols_rcpp, 10},
+    {"_pccc_ccc_factor_rcpp", (DL_FUNC) &_pccc_ccc_factor_rcpp, 6},
+    {"_pccc_ccc_cached_rcpp", (DL_FUNC) &_pccc_ccc_cached_rcpp, 9},
+    {"_pccc_ccc_expand", (DL_FUNC) &_pccc_ccc_expand, 2},
+    {"_pccc_ccc_memo_stats", (DL_FUNC) &_pccc_ccc_memo_stats, 0},
+    {"_pccc_ccc_cache_stats", (DL_FUNC) &_pccc_ccc_cache_stats, 0},
+    {"_pccc_ccc_file_rcpp", (DL_FUNC) &_pccc_ccc_file_rcpp, 11},
+    {"_pccc_ccc_index_rcpp", (DL_FUNC) &_pccc_ccc_index_rcpp, 4},
+    {"_pccc_ccc_query_rcpp", (DL_FUNC) &_pccc_ccc_query_rcpp, 4},
+    {"_pccc_ccc_index_save_rcpp", (DL_FUNC) &_pccc_ccc_index_save_rcpp, 2},
+    {"_pccc_ccc_index_load_rcpp", (DL_FUNC) &_pccc_ccc_index_load_rcpp, 1},
+    {"_pccc_ccc_long_rcpp", (DL_FUNC) &_pccc_ccc_long_rcpp, 6},
+    {"_pccc_ccc_lookback_rcpp", (DL_FUNC) &_pccc_ccc_lookback_rcpp, 7},
     {"_pccc_get_codes", (DL_FUNC) &_pccc_get_codes, 1},
+    {"_pccc_ccc_rules", (DL_FUNC) &_pccc_ccc_rules, 1},
+    {"_pccc_ccc_table_rcpp", (DL_FUNC) &_pccc_ccc_table_rcpp, 4},
     {NULL, NULL, 0}
 };
 
@@ -1,54 +1,813 @@
+#include <algorithm>
+#include <chrono>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <Rcpp.h>
+#include "mask_cache.h"
 #include "pccc.h"
+#include "rcpp_columns.h"
+#include "rcpp_groups.h"
+#include "rcpp_names.h"
+#include "rcpp_table.h"
+#include "task_group.h"
+
+// number of rows each thread classifies between checks for a user interrupt
+static const R_xlen_t ccc_rows_per_thread = 4096;
+
+// Hits and misses of the code memos during the last call to ccc_mat_rcpp,
+// dx then pc, see ccc_memo_stats.
+static double last_memo_stats[4] = {0, 0, 0, 0};
+
+// Rows found, changed and added during the last call to ccc_cached_rcpp and
+// the entries of the cache it saved, see ccc_cache_stats.
+static double last_cache_stats[4] = {0, 0, 0, 0};
+
+// The codes of a batch of rows, copied out of the R character matrices as
+// std::string_views, column by column, so that worker threads never need to
+// call the R API.  NA and empty cells are left as empty views.
+struct view_batch {
+  R_xlen_t begin;
+  R_xlen_t end;
+  std::vector<std::string_view> dx;
+  std::vector<std::string_view> pc;
+};
+
+// The columns of a character matrix.
+static std::vector<code_column> matrix_columns(const Rcpp::CharacterMatrix& m)
+{
+  std::vector<code_column> cols(m.ncol());
+  for (R_xlen_t j = 0; j < m.ncol(); ++j) {
+    cols[j] = code_column{STRING_PTR_RO(m) + j * m.nrow(), nullptr, 0};
+  }
+  return cols;
+}
+
+// The compiled codes of each row: those of one ICD version, or of a code
+// table from ccc_table(), for every row, or of the version given for each
+// row, so that data spanning the change from ICD-9 to ICD-10 can be
+// classified in one pass.
+class row_versions {
+  private:
+    const Rcpp::IntegerVector icdv;
+    const int* version;
+    const codes* icd[2];
+
+    static int slot(int v) { return v == 10; };
+
+  public:
+    row_versions(SEXP versions, R_xlen_t nrow)
+      : icdv(is_code_table(versions) ? Rcpp::IntegerVector() : Rcpp::IntegerVector(versions)),
+        version(nullptr), icd{nullptr, nullptr}
+    {
+      if (is_code_table(versions)) {
+        icd[0] = icd[1] = &table_codes(versions);
+        return;
+      }
+      if (icdv.size() != 1 && icdv.size() != nrow) {
+        Rcpp::stop("icdv must be a single version or one version per row.");
+      }
+      const R_xlen_t n = icdv.size();
+      for (R_xlen_t i = 0; i < n; ++i) {
+        const int v = icdv[i];
+        if (!icd[slot(v)] || icd[slot(v)]->get_version() != v) {
+          icd[slot(v)] = &codes::get(v);
+        }
+      }
+      if (n == 1) {
+        icd[1 - slot(icdv[0])] = icd[slot(icdv[0])];
+      } else {
+        version = icdv.begin();
+      }
+    };
+
+    const codes& at(R_xlen_t row) const {
+      return *icd[version ? slot(version[row]) : 0];
+    };
+
+    // the end of the run of rows from begin, before end, of one version
+    R_xlen_t run_end(R_xlen_t begin, R_xlen_t end) const {
+      if (!version) {
+        return end;
+      }
+      R_xlen_t i = begin + 1;
+      while (i < end && version[i] == version[begin]) {
+        ++i;
+      }
+      return i;
+    };
+
+    // 0 or 1, for keeping something per version, such as a memo
+    int index(R_xlen_t row) const {
+      return version ? slot(version[row]) : 0;
+    };
+
+    // the codes kept at an index, nullptr if no row uses them
+    const codes* at_index(int i) const {
+      return icd[i];
+    };
+};
+
+// What one thread did during a call to ccc_mat_rcpp with stats = TRUE.
+struct thread_stats {
+  classify_stats counts;
+  double match_seconds = 0;
+  double output_seconds = 0;
+};
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The (row, category) pairs of the flags which are set in one part of a batch,
+// 1-based, in row order.
+struct sparse_hits {
+  std::vector<int> row;
+  std::vector<int> category;
+};
+
+// The result of a call being filled in: a column per flag of a data.frame or
+// matrix, or one packed mask per row, written straight into the R object; or,
+// for output = "sparse", the flags found by each thread, put together in row
+// order after each batch.
+class flag_result {
+  private:
+    const R_xlen_t nrow;
+    Rcpp::RObject result;
+    std::vector<int*> cols;
+    int* bits;
+    const bool sparse;
+    std::vector<sparse_hits> part_hits;
+    sparse_hits hits;
+
+  public:
+    flag_result(const std::string& output, R_xlen_t nrow, int n_threads)
+      : nrow(nrow), bits(nullptr), sparse(output == "sparse"), part_hits(sparse ? n_threads : 0)
+    {
+      if (output == "data.frame") {
+        Rcpp::List df(CCC_FLAG + 1);
+        for (int j = 0; j <= CCC_FLAG; ++j) {
+          Rcpp::IntegerVector col(nrow);
+          cols.push_back(INTEGER(col));
+          df[j] = col;
+        }
+        df.attr("names") = category_names(true);
+        df.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -nrow);
+        df.attr("class") = "data.frame";
+        result = df;
+      } else if (output == "matrix") {
+        Rcpp::IntegerMatrix mat(nrow, CCC_FLAG + 1);
+        for (int j = 0; j <= CCC_FLAG; ++j) {
+          cols.push_back(INTEGER(mat) + j * nrow);
+        }
+        mat.attr("dimnames") = Rcpp::List::create(R_NilValue, category_names(true));
+        result = mat;
+      } else if (output == "bitmask") {
+        Rcpp::IntegerVector mask(nrow);
+        bits = INTEGER(mask);
+        result = mask;
+      } else if (!sparse) {
+        Rcpp::stop("output must be one of 'data.frame', 'matrix', 'bitmask' or 'sparse'.");
+      }
+    };
+
+    // Write the flags of rows [begin, end) of a batch starting at row
+    // batch_begin, from masks without the CCC_FLAG bit.  Thread k writes only
+    // its own rows and its own hits, so parts of a batch can be written in
+    // parallel.
+    void write(int k, R_xlen_t batch_begin, const uint16_t* masks, std::size_t begin, std::size_t end) {
+      auto flags = [masks](std::size_t i) -> int {
+        return masks[i] ? masks[i] | 1 << CCC_FLAG : 0;
+      };
+      if (bits) {
+        for (std::size_t i = begin; i < end; ++i) {
+          bits[batch_begin + i] = flags(i);
+        }
+      }
+      for (std::size_t j = 0; j < cols.size(); ++j) {
+        int* col = cols[j] + batch_begin;
+        for (std::size_t i = begin; i < end; ++i) {
+          col[i] = (flags(i) >> j) & 1;
+        }
+      }
+      if (sparse) {
+        sparse_hits& h = part_hits[k];
+        for (std::size_t i = begin; i < end; ++i) {
+          const int f = flags(i);
+          for (int j = 0; f >> j; ++j) {
+            if ((f >> j) & 1) {
+              h.row.push_back(static_cast<int>(batch_begin + i + 1));
+              h.category.push_back(j + 1);
+            }
+          }
+        }
+      }
+    };
+
+    // Move the hits of each thread, in thread and so row order, to the result
+    // after each batch.
+    void collect() {
+      for (std::size_t k = 0; k < part_hits.size(); ++k) {
+        hits.row.insert(hits.row.end(), part_hits[k].row.begin(), part_hits[k].row.end());
+        hits.category.insert(hits.category.end(), part_hits[k].category.begin(), part_hits[k].category.end());
+        part_hits[k].row.clear();
+        part_hits[k].category.clear();
+      }
+    };
+
+    Rcpp::RObject& finish() {
+      if (sparse) {
+        result = Rcpp::List::create(Rcpp::Named("i") = Rcpp::IntegerVector(hits.row.begin(), hits.row.end()),
+                                    Rcpp::Named("j") = Rcpp::IntegerVector(hits.category.begin(), hits.category.end()),
+                                    Rcpp::Named("dims") = Rcpp::IntegerVector::create(nrow, CCC_FLAG + 1),
+                                    Rcpp::Named("dimnames") = Rcpp::List::create(R_NilValue, category_names(true)));
+      }
+      return result;
+    };
+};
+
+// Classify nrow rows of code columns, as ccc_mat_rcpp and ccc_cols_rcpp.  The
+// codes are copied out of the columns as views one batch of rows at a time,
+// so the memory used besides the result does not grow with nrow.
+static SEXP classify_code_columns(const std::vector<code_column>& dx_cols,
+                                  const std::vector<code_column>& pc_cols, R_xlen_t nrow,
+                                  SEXP version, int n_threads, bool memoize,
+                                  const std::string& output, bool explain, bool stats,
+                                  bool normalize)
+{
+  auto start = std::chrono::steady_clock::now();
+  double convert_seconds = 0;
+  double output_seconds = 0;
+
+  if (n_threads < 1) {
+    Rcpp::stop("n_threads must be a positive integer.");
+  }
+  const row_versions versions(version, nrow);
+
+  flag_result result(output, nrow, n_threads);
+
+  output_seconds += seconds_since(start);
+
+  const R_xlen_t dx_ncol = dx_cols.size();
+  const R_xlen_t pc_ncol = pc_cols.size();
+  const R_xlen_t batch_size = ccc_rows_per_thread * n_threads;
+
+  // While the workers classify one batch the main thread copies the views of
+  // the next batch into the other buffer.
+  view_batch batches[2];
+  int current = 0;
+  thread_pool workers(n_threads);
+  std::vector<uint16_t> masks(std::min(batch_size, nrow));
+
+  // For each row and category, the column and rule which found it, see
+  // codes::explain_columns.
+  Rcpp::IntegerMatrix explain_column(explain ? nrow : 0, CCC_FLAG);
+  Rcpp::IntegerMatrix explain_rule(explain ? nrow : 0, CCC_FLAG);
+  int* where = INTEGER(explain_column);
+  int* rule = INTEGER(explain_rule);
+  std::fill(where, where + XLENGTH(explain_column), NA_INTEGER);
+  std::fill(rule, rule + XLENGTH(explain_rule), NA_INTEGER);
+
+  // one pair of memos per thread and ICD version, kept from batch to batch
+  std::vector<mask_memo> dx_memos(memoize ? 2 * n_threads : 0);
+  std::vector<mask_memo> pc_memos(memoize ? 2 * n_threads : 0);
+  std::vector<thread_stats> part_stats(stats ? n_threads : 0);
+
+  start = std::chrono::steady_clock::now();
+  batches[current].begin = 0;
+  batches[current].end = std::min(batch_size, nrow);
+  fill_views(batches[current].dx, dx_cols, batches[current].begin, batches[current].end);
+  fill_views(batches[current].pc, pc_cols, batches[current].begin, batches[current].end);
+  convert_seconds += seconds_since(start);
+
+  while (batches[current].begin < nrow) {
+    const view_batch& batch = batches[current];
+    const std::size_t len = batch.end - batch.begin;
+
+    // Each part of the batch is independent of the others and is written to
+    // its own rows of masks and of the result, so the result does not depend
+    // on n_threads.
+    auto classify_part = [&versions, &batch, &masks, &dx_memos, &pc_memos, memoize, explain, where, rule, nrow, len, &result, &part_stats, normalize, dx_ncol, pc_ncol](int k, std::size_t part_start, std::size_t part_end) {
+      auto part_time = std::chrono::steady_clock::now();
+      classify_stats* counts = part_stats.empty() ? nullptr : &part_stats[k].counts;
+      std::fill(masks.begin() + part_start, masks.begin() + part_end, 0);
+      // each run of rows of one ICD version is classified with its codes
+      for (std::size_t run = part_start; run < part_end; ) {
+        const std::size_t run_end = versions.run_end(batch.begin + run, batch.begin + part_end) - batch.begin;
+        const codes& cdv = versions.at(batch.begin + run);
+        const int m = 2 * k + versions.index(batch.begin + run);
+        if (explain) {
+          cdv.explain_columns(batch.dx.data(), dx_ncol, batch.pc.data(), pc_ncol,
+                              len, run, run_end, masks.data(),
+                              where + batch.begin, rule + batch.begin, nrow, counts, normalize);
+        } else if (memoize) {
+          cdv.classify_columns(batch.dx.data(), dx_ncol, batch.pc.data(), pc_ncol,
+                               len, run, run_end, masks.data(), dx_memos[m], pc_memos[m], counts, normalize);
+        } else {
+          cdv.classify_columns(batch.dx.data(), dx_ncol, batch.pc.data(), pc_ncol,
+                               len, run, run_end, masks.data(), counts, normalize);
+        }
+        run = run_end;
+      }
+      if (counts) {
+        part_stats[k].match_seconds += seconds_since(part_time);
+        part_time = std::chrono::steady_clock::now();
+      }
+      result.write(k, batch.begin, masks.data(), part_start, part_end);
+      if (counts) {
+        part_stats[k].output_seconds += seconds_since(part_time);
+      }
+    };
+
+    workers.start_parts(len, classify_part);
+
+    start = std::chrono::steady_clock::now();
+    view_batch& next = batches[1 - current];
+    next.begin = batch.end;
+    next.end = std::min(next.begin + batch_size, nrow);
+    fill_views(next.dx, dx_cols, next.begin, next.end);
+    fill_views(next.pc, pc_cols, next.begin, next.end);
+    convert_seconds += seconds_since(start);
+
+    workers.wait();
+    start = std::chrono::steady_clock::now();
+    result.collect();
+    output_seconds += seconds_since(start);
+    current = 1 - current;
+    Rcpp::checkUserInterrupt();
+  }
+
+  std::fill(last_memo_stats, last_memo_stats + 4, 0);
+  for (std::size_t k = 0; k < dx_memos.size(); ++k) {
+    last_memo_stats[0] += dx_memos[k].get_hits();
+    last_memo_stats[1] += dx_memos[k].get_misses();
+    last_memo_stats[2] += pc_memos[k].get_hits();
+    last_memo_stats[3] += pc_memos[k].get_misses();
+  }
+
+  start = std::chrono::steady_clock::now();
+  Rcpp::RObject& out = result.finish();
+
+  if (explain) {
+    explain_column.attr("dimnames") = Rcpp::List::create(R_NilValue, category_names());
+    explain_rule.attr("dimnames") = Rcpp::List::create(R_NilValue, category_names());
+    out.attr("ccc_explain") = Rcpp::List::create(Rcpp::Named("column") = explain_column,
+                                                 Rcpp::Named("rule") = explain_rule);
+  }
+  output_seconds += seconds_since(start);
+
+  if (stats) {
+    classify_stats counts;
+    double match_seconds = 0;
+    for (const thread_stats& t : part_stats) {
+      counts.add(t.counts);
+      match_seconds += t.match_seconds;
+      output_seconds += t.output_seconds;
+    }
+
+    Rcpp::NumericVector seconds = Rcpp::NumericVector::create(
+      Rcpp::Named("convert") = convert_seconds,
+      Rcpp::Named("match")   = match_seconds,
+      Rcpp::Named("output")  = output_seconds);
+    Rcpp::NumericVector totals = Rcpp::NumericVector::create(
+      Rcpp::Named("cells")   = static_cast<double>(counts.cells),
+      Rcpp::Named("codes")   = static_cast<double>(counts.codes),
+      Rcpp::Named("skipped") = static_cast<double>(counts.skipped),
+      Rcpp::Named("lookups") = static_cast<double>(counts.lookups),
+      Rcpp::Named("nodes")   = static_cast<double>(counts.nodes));
+    Rcpp::List categories = Rcpp::List::create(
+      Rcpp::Named("category") = category_names(),
+      Rcpp::Named("tests")    = Rcpp::NumericVector(counts.tests, counts.tests + CCC_FLAG),
+      Rcpp::Named("hits")     = Rcpp::NumericVector(counts.hits, counts.hits + CCC_FLAG));
+    categories.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -CCC_FLAG);
+    categories.attr("class") = "data.frame";
+
+    out.attr("ccc_stats") = Rcpp::List::create(Rcpp::Named("seconds") = seconds,
+                                               Rcpp::Named("counts") = totals,
+                                               Rcpp::Named("categories") = categories);
+  }
+
+  return out;
+}
 
 // [[Rcpp::export]]
-Rcpp::DataFrame ccc_mat_rcpp(Rcpp::CharacterMatrix& dx, Rcpp::CharacterMatrix& pc, int version = 9)
+SEXP ccc_mat_rcpp(Rcpp::CharacterMatrix& dx, Rcpp::CharacterMatrix& pc, SEXP version, int n_threads = 1, bool memoize = true, std::string output = "data.frame", bool explain = false, bool stats = false, bool normalize = false)
 {
-  codes cdv(version);
+  if (pc.nrow() != dx.nrow()) {
+    Rcpp::stop("dx and pc must have the same number of rows.");
+  }
+  return classify_code_columns(matrix_columns(dx), matrix_columns(pc), dx.nrow(), version,
+                               n_threads, memoize, output, explain, stats, normalize);
+}
 
-  Rcpp::CharacterVector ccc_mat_rcpp_col_names(codes::col_names);
-  ccc_mat_rcpp_col_names.push_back("ccc_flag");
+// ccc_mat_rcpp for the code columns of a data.frame, given as lists of
+// character vectors and factors, either of which may be empty.  The columns
+// are read in place.
+// [[Rcpp::export]]
+SEXP ccc_cols_rcpp(Rcpp::List dx, Rcpp::List pc, int nrow, SEXP version, int n_threads = 1, bool memoize = true, std::string output = "data.frame", bool explain = false, bool stats = false, bool normalize = false)
+{
+  return classify_code_columns(list_columns(dx, nrow), list_columns(pc, nrow), nrow, version,
+                               n_threads, memoize, output, explain, stats, normalize);
+}
 
-  Rcpp::IntegerMatrix outmat(dx.nrow(), 13);
+// One factor column of codes: its integer codes and the category mask of each
+// of its levels, for the codes at each index of row_versions.
+struct factor_column {
+  const int* code;
+  std::vector<uint16_t> level_mask[2];
+};
 
-  Rcpp::CharacterVector dx_row;
-  Rcpp::CharacterVector pc_row;
-  std::vector<std::string> dx_str;
-  std::vector<std::string> pc_str;
+// Match the levels of each factor column once.  Columns usually share their
+// levels, whose CHARSXPs R keeps once in its string cache, so memos[v] matches
+// each distinct level only once for the codes at index v.
+static std::vector<factor_column> factor_columns(const Rcpp::List& cols, R_xlen_t nrow,
+                                                 const row_versions& versions, bool pc,
+                                                 bool normalize, mask_memo* memos)
+{
+  std::vector<factor_column> out(cols.size());
+  for (R_xlen_t j = 0; j < cols.size(); ++j) {
+    SEXP col = cols[j];
+    if (!Rf_isFactor(col)) {
+      Rcpp::stop("Code columns must be factors.");
+    }
+    if (XLENGTH(col) != nrow) {
+      Rcpp::stop("All code columns must have the same number of rows.");
+    }
+    SEXP levels = Rf_getAttrib(col, R_LevelsSymbol);
+    const R_xlen_t n_levels = XLENGTH(levels);
+    out[j].code = INTEGER(col);
 
-  for (int i=0; i < dx.nrow(); ++i) {
-    dx_row = dx.row(i);
-    pc_row = pc.row(i);
-    dx_str = Rcpp::as<std::vector<std::string>>(dx_row);
-    pc_str = Rcpp::as<std::vector<std::string>>(pc_row);
+    for (int v = 0; v < 2; ++v) {
+      const codes* cdv = versions.at_index(v);
+      // with one version for every row only index 0 is used
+      if (!cdv || (v == 1 && cdv == versions.at_index(0))) {
+        continue;
+      }
+      std::vector<uint16_t>& masks = out[j].level_mask[v];
+      masks.resize(n_levels);
+      for (R_xlen_t l = 0; l < n_levels; ++l) {
+        SEXP level = STRING_ELT(levels, l);
+        if (level == NA_STRING) {
+          masks[l] = 0;
+          continue;
+        }
+        std::string_view code(CHAR(level), LENGTH(level));
+        masks[l] = memos[v].get(CHAR(level), [cdv, code, pc, normalize]() {
+          return pc ? cdv->match_pc(code, 0, normalize) : cdv->match_dx(code, 0, normalize);
+        });
+      }
+    }
+  }
+  return out;
+}
+
+// ccc_mat_rcpp for code columns which are all factors.  The levels of each
+// column are matched once, and the flags of each row are the OR of the masks
+// of its levels, so no character matrix is made and no code is looked up per
+// row.  Lists of factors are read in place; explain and stats are not
+// supported.
+// [[Rcpp::export]]
+SEXP ccc_factor_rcpp(Rcpp::List dx, Rcpp::List pc, SEXP version, int n_threads = 1, std::string output = "data.frame", bool normalize = false)
+{
+  if (dx.size() + pc.size() == 0) {
+    Rcpp::stop("There are no code columns.");
+  }
+  if (n_threads < 1) {
+    Rcpp::stop("n_threads must be a positive integer.");
+  }
+  const R_xlen_t nrow = XLENGTH(dx.size() ? dx[0] : pc[0]);
+  const row_versions versions(version, nrow);
+
+  mask_memo dx_memos[2];
+  mask_memo pc_memos[2];
+  std::vector<factor_column> cols = factor_columns(dx, nrow, versions, false, normalize, dx_memos);
+  const std::vector<factor_column> pc_cols = factor_columns(pc, nrow, versions, true, normalize, pc_memos);
+  cols.insert(cols.end(), pc_cols.begin(), pc_cols.end());
+
+  flag_result result(output, nrow, n_threads);
+  const R_xlen_t batch_size = ccc_rows_per_thread * n_threads;
+  std::vector<uint16_t> masks(std::min(batch_size, nrow));
+  thread_pool workers(n_threads);
+
+  for (R_xlen_t batch_begin = 0; batch_begin < nrow; batch_begin += batch_size) {
+    const std::size_t len = std::min(batch_size, nrow - batch_begin);
+
+    auto classify_part = [&versions, &cols, &masks, &result, batch_begin](int k, std::size_t part_start, std::size_t part_end) {
+      std::fill(masks.begin() + part_start, masks.begin() + part_end, 0);
+      for (const factor_column& col : cols) {
+        const int* code = col.code + batch_begin;
+        for (std::size_t i = part_start; i < part_end; ++i) {
+          const std::vector<uint16_t>& level_mask = col.level_mask[versions.index(batch_begin + i)];
+          const int c = code[i];
+          // NA_INTEGER is negative
+          if (c > 0 && static_cast<std::size_t>(c) <= level_mask.size()) {
+            masks[i] |= level_mask[c - 1];
+          }
+        }
+      }
+      result.write(k, batch_begin, masks.data(), part_start, part_end);
+    };
+
+    workers.start_parts(len, classify_part);
+    workers.wait();
+    result.collect();
+    Rcpp::checkUserInterrupt();
+  }
+
+  last_memo_stats[0] = dx_memos[0].get_hits() + dx_memos[1].get_hits();
+  last_memo_stats[1] = dx_memos[0].get_misses() + dx_memos[1].get_misses();
+  last_memo_stats[2] = pc_memos[0].get_hits() + pc_memos[1].get_hits();
+  last_memo_stats[3] = pc_memos[0].get_misses() + pc_memos[1].get_misses();
+
+  return result.finish();
+}
+
+// The hash of the id of each row, for mask_cache: of the characters of a
+// string or factor level, or of the value of a number, so that an integer id
+// hashes as the same number stored as a double.
+static std::vector<uint64_t> id_hashes(SEXP id)
+{
+  const R_xlen_t n = XLENGTH(id);
+  std::vector<uint64_t> out(n);
 
-    outmat(i,  0) = cdv.neuromusc(dx_str, pc_str);
-    outmat(i,  1) = cdv.cvd(dx_str, pc_str);
-    outmat(i,  2) = cdv.respiratory(dx_str, pc_str);
-    outmat(i,  3) = cdv.renal(dx_str, pc_str);
-    outmat(i,  4) = cdv.gi(dx_str, pc_str);
-    outmat(i,  5) = cdv.hemato_immu(dx_str, pc_str);
-    outmat(i,  6) = cdv.metabolic(dx_str, pc_str);
-    outmat(i,  7) = cdv.congeni_genetic(dx_str);
-    outmat(i,  8) = cdv.malignancy(dx_str, pc_str);
-    outmat(i,  9) = cdv.neonatal(dx_str);
+  auto string_hash = [](SEXP s) {
+    return s == NA_STRING ? mask_cache::id_hash(nullptr, 0) + 1
+                          : mask_cache::id_hash(CHAR(s), LENGTH(s));
+  };
+  auto number_hash = [](double x) {
+    const uint64_t key = double_key(x);
+    return mask_cache::id_hash(&key, sizeof key) + 2;
+  };
 
-    outmat(i, 10) = cdv.tech_dep(dx_str, pc_str);
-    outmat(i, 11) = cdv.transplant(dx_str, pc_str);
+  if (Rf_isFactor(id)) {
+    SEXP levels = Rf_getAttrib(id, R_LevelsSymbol);
+    const int* x = INTEGER(id);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      out[i] = x[i] > 0 && x[i] <= XLENGTH(levels) ? string_hash(STRING_ELT(levels, x[i] - 1))
+                                                   : string_hash(NA_STRING);
+    }
+    return out;
+  }
 
-    if (sum(outmat.row(i))) {
-      outmat(i, 12) = 1;
+  switch (TYPEOF(id)) {
+    case INTSXP:
+    case LGLSXP: {
+      const int* x = TYPEOF(id) == INTSXP ? INTEGER(id) : LOGICAL(id);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        out[i] = number_hash(x[i] == NA_INTEGER ? NA_REAL : x[i]);
+      }
+      break;
+    }
+    case REALSXP: {
+      const double* x = REAL(id);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        out[i] = number_hash(x[i]);
+      }
+      break;
     }
+    case STRSXP: {
+      const SEXP* x = STRING_PTR_RO(id);
+      for (R_xlen_t i = 0; i < n; ++i) {
+        out[i] = string_hash(x[i]);
+      }
+      break;
+    }
+    default:
+      Rcpp::stop("id must be an integer, numeric, character or factor vector.");
+  }
+  return out;
+}
+
+// ccc_cols_rcpp with a cache of the masks of an earlier run kept in the file
+// cache.  Each row is hashed with its id, its codes and the tables of its
+// version, and only the rows not found in the cache are classified.  The
+// cache is then replaced by the rows of this call.
+// [[Rcpp::export]]
+SEXP ccc_cached_rcpp(SEXP id, Rcpp::List dx, Rcpp::List pc, int nrow, SEXP version, std::string cache, int n_threads = 1, std::string output = "data.frame", bool normalize = false)
+{
+  if (n_threads < 1) {
+    Rcpp::stop("n_threads must be a positive integer.");
+  }
+  if (XLENGTH(id) != nrow) {
+    Rcpp::stop("id must have one value for each row.");
+  }
+  const std::vector<code_column> dx_cols = list_columns(dx, nrow);
+  const std::vector<code_column> pc_cols = list_columns(pc, nrow);
+  const std::size_t dx_ncol = dx_cols.size();
+  const std::size_t pc_ncol = pc_cols.size();
+  const row_versions versions(version, nrow);
+  const std::vector<uint64_t> ids = id_hashes(id);
+  const mask_cache old = mask_cache::load(cache);
+
+  flag_result result(output, nrow, 1);
+  const R_xlen_t batch_size = ccc_rows_per_thread * n_threads;
+  std::vector<cache_entry> entries(nrow);
+  std::vector<uint16_t> masks(std::min(batch_size, static_cast<R_xlen_t>(nrow)));
+  std::vector<unsigned char> state(masks.size());
+  std::vector<std::string_view> dx_views;
+  std::vector<std::string_view> pc_views;
+
+  // the rows of a batch not found in the cache, and their codes and masks
+  std::vector<std::size_t> miss;
+  std::vector<std::string_view> dx_miss;
+  std::vector<std::string_view> pc_miss;
+  std::vector<uint16_t> miss_masks;
+  std::vector<mask_memo> dx_memos(2 * n_threads);
+  std::vector<mask_memo> pc_memos(2 * n_threads);
+  double counts[3] = {0, 0, 0};
+  thread_pool workers(n_threads);
+
+  for (R_xlen_t batch_begin = 0; batch_begin < nrow; batch_begin += batch_size) {
+    const std::size_t len = std::min(batch_size, nrow - batch_begin);
+    fill_views(dx_views, dx_cols, batch_begin, batch_begin + len);
+    fill_views(pc_views, pc_cols, batch_begin, batch_begin + len);
+
+    workers.start_parts(len, [&](int, std::size_t part_start, std::size_t part_end) {
+      for (std::size_t i = part_start; i < part_end; ++i) {
+        const R_xlen_t row = batch_begin + i;
+        const uint64_t h = mask_cache::codes_hash(dx_views.data(), dx_ncol, pc_views.data(), pc_ncol,
+                                                  len, i, versions.at(row).get_hash(), normalize);
+        entries[row] = cache_entry{ids[row], h, 0};
+        masks[i] = 0;
+        state[i] = old.find(ids[row], h, masks[i]);
+      }
+    });
+    workers.wait();
+
+    miss.clear();
+    for (std::size_t i = 0; i < len; ++i) {
+      ++counts[state[i]];
+      if (state[i] != mask_cache::found) {
+        miss.push_back(i);
+      }
+    }
+
+    const std::size_t n_miss = miss.size();
+    dx_miss.resize(n_miss * dx_ncol);
+    pc_miss.resize(n_miss * pc_ncol);
+    miss_masks.assign(n_miss, 0);
+    for (std::size_t j = 0; j < dx_ncol; ++j) {
+      for (std::size_t m = 0; m < n_miss; ++m) {
+        dx_miss[j * n_miss + m] = dx_views[j * len + miss[m]];
+      }
+    }
+    for (std::size_t j = 0; j < pc_ncol; ++j) {
+      for (std::size_t m = 0; m < n_miss; ++m) {
+        pc_miss[j * n_miss + m] = pc_views[j * len + miss[m]];
+      }
+    }
+
+    workers.start_parts(n_miss, [&](int k, std::size_t part_start, std::size_t part_end) {
+      // each run of rows of one ICD version is classified with its codes
+      for (std::size_t run = part_start; run < part_end; ) {
+        const int v = versions.index(batch_begin + miss[run]);
+        std::size_t run_end = run + 1;
+        while (run_end < part_end && versions.index(batch_begin + miss[run_end]) == v) {
+          ++run_end;
+        }
+        versions.at(batch_begin + miss[run]).classify_columns(
+          dx_miss.data(), dx_ncol, pc_miss.data(), pc_ncol, n_miss, run, run_end,
+          miss_masks.data(), dx_memos[2 * k + v], pc_memos[2 * k + v], nullptr, normalize);
+        run = run_end;
+      }
+    });
+    workers.wait();
+
+    for (std::size_t m = 0; m < n_miss; ++m) {
+      masks[miss[m]] = miss_masks[m];
+    }
+    for (std::size_t i = 0; i < len; ++i) {
+      entries[batch_begin + i].mask = masks[i];
+    }
+    result.write(0, batch_begin, masks.data(), 0, len);
+    result.collect();
     Rcpp::checkUserInterrupt();
   }
 
-  outmat.attr("dimnames") = Rcpp::List::create(Rcpp::CharacterVector::create(),
-              ccc_mat_rcpp_col_names
-  );
+  const mask_cache updated(std::move(entries));
+  updated.save(cache);
+
+  std::copy(counts, counts + 3, last_cache_stats);
+  last_cache_stats[3] = static_cast<double>(updated.size());
+  std::fill(last_memo_stats, last_memo_stats + 4, 0);
+  for (std::size_t k = 0; k < dx_memos.size(); ++k) {
+    last_memo_stats[0] += dx_memos[k].get_hits();
+    last_memo_stats[1] += dx_memos[k].get_misses();
+    last_memo_stats[2] += pc_memos[k].get_hits();
+    last_memo_stats[3] += pc_memos[k].get_misses();
+  }
 
-//  return outmat;
- Rcpp::DataFrame out = Rcpp::internal::convert_using_rfunction(outmat, "as.data.frame");
- return out;
+  return result.finish();
+}
 
+//' Expand Packed CCC Flags
+//'
+//' Expand the masks returned by \code{ccc(..., output = "bitmask")} into
+//' integer (0 or 1) columns.
+//'
+//' Bit \code{j - 1} of each mask is the \code{j}-th of the categories
+//' \code{neuromusc}, \code{cvd}, \code{respiratory}, \code{renal},
+//' \code{gi}, \code{hemato_immu}, \code{metabolic}, \code{congeni_genetic},
+//' \code{malignancy}, \code{neonatal}, \code{tech_dep}, \code{transplant}
+//' and \code{ccc_flag}, so for example \code{bitwAnd(mask, 4L) > 0} tests for
+//' \code{respiratory}.
+//'
+//' @param mask integer vector of masks.
+//' @param categories names of the categories to expand, by default all of them.
+//'
+//' @return
+//' A \code{data.frame} with an integer column for each of \code{categories}.
+//' \code{NA} masks give \code{NA} flags.
+//'
+//' @seealso \code{\link{ccc}}
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List ccc_expand(Rcpp::IntegerVector mask, SEXP categories = R_NilValue)
+{
+  const Rcpp::CharacterVector all = category_names(true);
+  Rcpp::CharacterVector names = Rf_isNull(categories) ? all : Rcpp::CharacterVector(categories);
+  const R_xlen_t n = mask.size();
+  const int* m = INTEGER(mask);
+  Rcpp::List out(names.size());
+
+  for (R_xlen_t k = 0; k < names.size(); ++k) {
+    int j = 0;
+    while (j < all.size() && std::string(all[j]) != std::string(names[k])) {
+      ++j;
+    }
+    if (j == all.size()) {
+      Rcpp::stop("Unknown category '" + std::string(names[k]) + "'.");
+    }
+
+    Rcpp::IntegerVector col(n);
+    int* c = INTEGER(col);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      c[i] = m[i] == NA_INTEGER ? NA_INTEGER : (m[i] >> j) & 1;
+    }
+    out[k] = col;
+  }
+
+  out.attr("names") = names;
+  out.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -n);
+  out.attr("class") = "data.frame";
+  return out;
+}
+
+//' Code Memo Statistics
+//'
+//' Hits and misses of the code memos during the last call to \code{\link{ccc}}.
+//'
+//' With \code{memoize = TRUE}, \code{ccc} looks up each distinct diagnostic
+//' and procedure code once per thread and reuses its flags for every other
+//' cell holding the same code.  A miss is a code looked up in the CCC code
+//' tables; a hit is a cell whose flags were found in the memo instead.  Cells
+//' which are \code{NA} or empty, or which are skipped because their row
+//' already has every flag it could get, are neither.  Few hits relative to
+//' misses mean that most codes are distinct and \code{memoize = FALSE} may be
+//' faster.
+//'
+//' @return
+//' A named numeric vector with elements \code{dx_hits}, \code{dx_misses},
+//' \code{pc_hits} and \code{pc_misses}.  All are zero after a call with
+//' \code{memoize = FALSE}.
+//'
+//' @seealso \code{\link{ccc}}
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::NumericVector ccc_memo_stats()
+{
+  Rcpp::NumericVector stats(last_memo_stats, last_memo_stats + 4);
+  stats.attr("names") = Rcpp::CharacterVector::create("dx_hits", "dx_misses", "pc_hits", "pc_misses");
+  return stats;
+}
+
+//' Classification Cache Statistics
+//'
+//' What the last call to \code{\link{ccc}} with a \code{cache} file found in
+//' it.
+//'
+//' A row is found when the cache holds a row with the same id, the same codes,
+//' in any order, and the same code tables, and its flags are taken from the
+//' cache.  A row is changed when the cache holds its id but not with these
+//' codes or tables, and added when the cache does not hold its id.  Changed
+//' and added rows are classified.  After a change to the code tables every
+//' row is changed.
+//'
+//' @return
+//' A named numeric vector with elements \code{found}, \code{changed},
+//' \code{added} and \code{saved}, the number of rows of the cache written.
+//' All are zero before the first call with a cache.
+//'
+//' @seealso \code{\link{ccc}}
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::NumericVector ccc_cache_stats()
+{
+  Rcpp::NumericVector stats(last_cache_stats, last_cache_stats + 4);
+  stats.attr("names") = Rcpp::CharacterVector::create("found", "changed", "added", "saved");
+  return stats;
 }
@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Rcpp.h>
+#include "pccc.h"
+#include "delim_reader.h"
+#include "flag_output.h"
+#include "mapped_file.h"
+#include "rcpp_table.h"
+#include "task_group.h"
+
+// Find the columns selected by name, by name prefix ending in '*', or by
+// 1-based index, in the header.
+static std::vector<std::size_t> resolve_columns(SEXP selection, const std::vector<std::string>& header)
+{
+  std::vector<std::size_t> cols;
+  const std::size_t n_fields = header.size();
+
+  if (Rf_isNull(selection)) {
+    return cols;
+  }
+
+  if (TYPEOF(selection) == STRSXP) {
+    for (R_xlen_t i = 0; i < XLENGTH(selection); ++i) {
+      select_columns(CHAR(STRING_ELT(selection, i)), header, cols);
+    }
+  } else if (TYPEOF(selection) == INTSXP || TYPEOF(selection) == REALSXP) {
+    Rcpp::IntegerVector idx(selection);
+    for (R_xlen_t i = 0; i < idx.size(); ++i) {
+      if (idx[i] == NA_INTEGER || idx[i] < 1 || static_cast<std::size_t>(idx[i]) > n_fields) {
+        Rcpp::stop("Column indices must be between 1 and the number of columns in the input file.");
+      }
+      cols.push_back(idx[i] - 1);
+    }
+  } else {
+    Rcpp::stop("Columns must be selected by name or by index.");
+  }
+
+  return cols;
+}
+
+// The id column, if any, and the CCC flags of a set of rows as a data.frame.
+static Rcpp::List flags_data_frame(const std::vector<std::string>& ids, bool has_id,
+                                   const std::string& id_name,
+                                   const std::vector<uint16_t>& masks)
+{
+  const R_xlen_t n = masks.size();
+  const int n_cols = (has_id ? 1 : 0) + CCC_FLAG + 1;
+  Rcpp::List out(n_cols);
+  Rcpp::CharacterVector names(n_cols);
+  int k = 0;
+
+  if (has_id) {
+    Rcpp::CharacterVector id(n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      id[i] = Rf_mkCharLenCE(ids[i].data(), static_cast<int>(ids[i].size()), CE_UTF8);
+    }
+    out[k] = id;
+    names[k++] = id_name;
+  }
+
+  for (int j = 0; j <= CCC_FLAG; ++j) {
+    Rcpp::IntegerVector flag(n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+      flag[i] = (masks[i] >> j) & 1;
+    }
+    out[k] = flag;
+    names[k++] = flag_name(j);
+  }
+
+  out.attr("names") = names;
+  out.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -n);
+  out.attr("class") = "data.frame";
+  return out;
+}
+
+// Where the results of ccc_file_rcpp go: an output file, a callback called
+// once per chunk, or a data.frame returned at the end.  Closes the output file
+// however ccc_file_rcpp exits.
+class flag_sink {
+  private:
+    std::FILE* file;
+    SEXP callback;
+    bool has_id;
+    std::string id_name;
+    std::vector<std::string> all_ids;
+    std::vector<uint16_t> all_masks;
+    R_xlen_t n_rows;
+
+  public:
+    flag_sink(SEXP output, SEXP cb, bool id, const std::string& name, char delim)
+      : file(nullptr), callback(cb), has_id(id), id_name(name), n_rows(0)
+    {
+      if (Rf_isNull(output)) {
+        return;
+      }
+
+      std::string path = Rcpp::as<std::string>(output);
+      file = std::fopen(path.c_str(), "wb");
+      if (!file) {
+        Rcpp::stop("Unable to open '" + path + "' for writing.");
+      }
+
+      std::string line;
+      append_header(line, has_id, id_name, delim);
+      write_lines(line, 0);
+    };
+
+    ~flag_sink() {
+      if (file) {
+        std::fclose(file);
+      }
+    };
+
+    flag_sink(const flag_sink&) = delete;
+    flag_sink& operator=(const flag_sink&) = delete;
+
+    // True if the rows are to be formatted, see append_row, and passed to
+    // write_lines rather than to add_rows.
+    bool writes_text() const { return file != nullptr; };
+
+    void write_lines(const std::string& lines, std::size_t n) {
+      if (std::fwrite(lines.data(), 1, lines.size(), file) != lines.size()) {
+        Rcpp::stop("Error writing the output file.");
+      }
+      n_rows += n;
+    };
+
+    void add_rows(const std::vector<std::string>& ids, const std::vector<uint16_t>& masks) {
+      if (!Rf_isNull(callback)) {
+        Rcpp::Function f(callback);
+        f(flags_data_frame(ids, has_id, id_name, masks));
+      } else {
+        all_ids.insert(all_ids.end(), ids.begin(), ids.end());
+        all_masks.insert(all_masks.end(), masks.begin(), masks.end());
+      }
+      n_rows += masks.size();
+    };
+
+    SEXP result() const {
+      if (file || !Rf_isNull(callback)) {
+        return Rf_ScalarReal(static_cast<double>(n_rows));
+      }
+      return flags_data_frame(all_ids, has_id, id_name, all_masks);
+    };
+};
+
+// The selected id, dx and pc columns of the input file.
+struct file_columns {
+  std::vector<std::size_t> id;
+  std::vector<std::size_t> dx;
+  std::vector<std::size_t> pc;
+  std::string id_name;
+
+  file_columns(SEXP id_sel, SEXP dx_sel, SEXP pc_sel, const std::vector<std::string>& header)
+    : id(resolve_columns(id_sel, header)),
+      dx(resolve_columns(dx_sel, header)),
+      pc(resolve_columns(pc_sel, header))
+  {
+    if (id.size() > 1) {
+      Rcpp::stop("Only one id column can be selected.");
+    }
+    if (!id.empty()) {
+      id_name = header[id[0]];
+    }
+  };
+
+  bool has_id() const { return !id.empty(); };
+};
+
+// Passes each chunk classified by classify_stream to a flag_sink.
+class stream_sink : public row_sink {
+  private:
+    flag_sink& sink;
+    const file_columns& cols;
+    char delim;
+    std::vector<std::string> ids;
+    std::vector<uint16_t> masks;
+    std::string lines;
+
+  public:
+    stream_sink(flag_sink& sink, const file_columns& cols, char delim)
+      : sink(sink), cols(cols), delim(delim) {};
+
+    void add_rows(const delim_chunk& chunk, const uint16_t* chunk_masks) override {
+      const std::size_t n = chunk.size();
+      if (sink.writes_text()) {
+        lines.clear();
+        append_rows(lines, chunk, chunk_masks, cols.id, delim);
+        sink.write_lines(lines, n);
+      } else {
+        ids.clear();
+        for (std::size_t i = 0; cols.has_id() && i < n; ++i) {
+          ids.emplace_back(chunk.field(i, cols.id[0]));
+        }
+        masks.assign(chunk_masks, chunk_masks + n);
+        sink.add_rows(ids, masks);
+      }
+      Rcpp::checkUserInterrupt();
+    };
+};
+
+// Read the file chunk_size records at a time with a delim_reader.
+static SEXP ccc_file_stream(const codes& cdv, const std::string& file, SEXP id, SEXP dx_cols,
+                            SEXP pc_cols, SEXP output, SEXP callback, char delim,
+                            int chunk_size, int n_threads)
+{
+  delim_reader reader(file, delim);
+  const std::vector<std::string> header = read_header(reader);
+  if (header.empty()) {
+    Rcpp::stop("The input file is empty.");
+  }
+
+  const file_columns cols(id, dx_cols, pc_cols, header);
+  flag_sink sink(output, callback, cols.has_id(), cols.id_name, delim);
+  stream_sink rows(sink, cols, delim);
+  classify_stream(cdv, reader, cols.dx, cols.pc, chunk_size, n_threads, rows);
+
+  return sink.result();
+}
+
+// A run of whole lines of a mapped file and the results for them, filled in by
+// one worker thread.
+struct mapped_piece {
+  const char* begin;
+  const char* end;
+  std::vector<std::string_view> fields;
+  std::vector<std::string_view> dx;
+  std::vector<std::string_view> pc;
+  std::vector<std::string> ids;
+  std::vector<uint16_t> masks;
+  std::string lines;
+  std::size_t n;
+};
+
+// End of the line starting at p, not including the newline.
+static const char* line_end(const char* p, const char* end)
+{
+  const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return nl ? nl : end;
+}
+
+static bool blank_line(const char* begin, const char* end)
+{
+  return begin == end || (end - begin == 1 && *begin == '\r');
+}
+
+// Split and classify every line of a piece.  Only reads the mapped file and
+// writes the piece, so pieces can be classified in parallel.
+static void classify_piece(const codes& cdv, const file_columns& cols, char delim,
+                           bool text, mapped_piece& piece)
+{
+  piece.ids.clear();
+  piece.masks.clear();
+  piece.lines.clear();
+  piece.n = 0;
+  piece.dx.resize(cols.dx.size());
+  piece.pc.resize(cols.pc.size());
+
+  for (const char* p = piece.begin; p < piece.end; ) {
+    const char* e = line_end(p, piece.end);
+    const char* line = p;
+    p = e + 1;
+    if (blank_line(line, e)) {
+      continue;
+    }
+
+    split_line(line, e, delim, piece.fields);
+    const std::size_t n_fields = piece.fields.size();
+    for (std::size_t j = 0; j < cols.dx.size(); ++j) {
+      piece.dx[j] = cols.dx[j] < n_fields ? piece.fields[cols.dx[j]] : std::string_view();
+    }
+    for (std::size_t j = 0; j < cols.pc.size(); ++j) {
+      piece.pc[j] = cols.pc[j] < n_fields ? piece.fields[cols.pc[j]] : std::string_view();
+    }
+
+    uint16_t mask = cdv.classify(piece.dx.data(), piece.dx.size(), piece.pc.data(), piece.pc.size());
+    std::string id;
+    if (cols.has_id() && cols.id[0] < n_fields) {
+      id = unquote(piece.fields[cols.id[0]]);
+    }
+
+    if (text) {
+      append_row(piece.lines, cols.has_id(), id, mask, delim);
+    } else {
+      if (cols.has_id()) {
+        piece.ids.push_back(std::move(id));
+      }
+      piece.masks.push_back(mask);
+    }
+    ++piece.n;
+  }
+}
+
+// Map the whole file into memory and split it at newlines into pieces of
+// about chunk_size rows, n_threads of which are classified at a time.
+static SEXP ccc_file_mapped(const codes& cdv, const std::string& file, SEXP id, SEXP dx_cols,
+                            SEXP pc_cols, SEXP output, SEXP callback, char delim,
+                            int chunk_size, int n_threads)
+{
+  mapped_file map(file);
+  const char* p = map.data();
+  const char* const end = map.data() + map.size();
+
+  const char* e = p;
+  while (p < end && blank_line(p, e = line_end(p, end))) {
+    p = e + 1;
+  }
+  if (p >= end) {
+    Rcpp::stop("The input file is empty.");
+  }
+
+  std::vector<std::string_view> fields;
+  split_line(p, e, delim, fields);
+  std::vector<std::string> header;
+  for (std::size_t j = 0; j < fields.size(); ++j) {
+    header.push_back(unquote(fields[j]));
+  }
+  p = std::min(e + 1, end);
+
+  const file_columns cols(id, dx_cols, pc_cols, header);
+  flag_sink sink(output, callback, cols.has_id(), cols.id_name, delim);
+
+  // size the pieces from the average length of the first lines
+  std::size_t sampled = 0;
+  const char* q = p;
+  while (q < end && sampled < 1000) {
+    q = line_end(q, end) + 1;
+    ++sampled;
+  }
+  const std::size_t row_bytes = sampled ? (std::min(q, end) - p) / sampled + 1 : 1;
+  const std::size_t piece_bytes = std::max<std::size_t>(4096, row_bytes * chunk_size);
+
+  std::vector<mapped_piece> pieces(n_threads);
+  const bool text = sink.writes_text();
+  thread_pool workers(n_threads);
+
+  while (p < end) {
+    std::size_t n_pieces = 0;
+    for (; n_pieces < pieces.size() && p < end; ++n_pieces) {
+      mapped_piece& piece = pieces[n_pieces];
+      piece.begin = p;
+      if (static_cast<std::size_t>(end - p) <= piece_bytes) {
+        piece.end = end;
+      } else {
+        piece.end = std::min(line_end(p + piece_bytes, end) + 1, end);
+      }
+      p = piece.end;
+    }
+
+    workers.start_parts(n_pieces, [&](int, std::size_t begin, std::size_t stop) {
+      for (std::size_t k = begin; k < stop; ++k) {
+        classify_piece(cdv, cols, delim, text, pieces[k]);
+      }
+    });
+    workers.wait();
+
+    for (std::size_t k = 0; k < n_pieces; ++k) {
+      if (pieces[k].n == 0) {
+        continue;
+      }
+      if (text) {
+        sink.write_lines(pieces[k].lines, pieces[k].n);
+      } else {
+        sink.add_rows(pieces[k].ids, pieces[k].masks);
+      }
+    }
+
+    Rcpp::checkUserInterrupt();
+  }
+
+  return sink.result();
+}
+
+// [[Rcpp::export]]
+SEXP ccc_file_rcpp(std::string file, SEXP id, SEXP dx_cols, SEXP pc_cols, SEXP version,
+                   SEXP output, SEXP callback, std::string delim, int chunk_size, int n_threads,
+                   bool mmap)
+{
+  const codes& cdv = codes_for(version);
+
+  if (delim.size() != 1) {
+    Rcpp::stop("delim must be a single character.");
+  }
+  if (chunk_size < 1) {
+    Rcpp::stop("chunk_size must be a positive integer.");
+  }
+  if (n_threads < 1) {
+    Rcpp::stop("n_threads must be a positive integer.");
+  }
+
+  if (mmap) {
+    return ccc_file_mapped(cdv, file, id, dx_cols, pc_cols, output, callback, delim[0],
+                           chunk_size, n_threads);
+  }
+  return ccc_file_stream(cdv, file, id, dx_cols, pc_cols, output, callback, delim[0],
+                         chunk_size, n_threads);
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Rcpp.h>
+#include "code_index.h"
+#include "pccc.h"
+#include "rcpp_columns.h"
+
+// number of rows indexed between checks for a user interrupt
+static const R_xlen_t ccc_index_batch = 65536;
+
+// The handles returned by ccc_index() and ccc_index_load() are external
+// pointers of class "pccc_index" owning the index, with its size as
+// attributes for printing.
+static SEXP index_handle(code_index&& index)
+{
+  Rcpp::XPtr<code_index> handle(new code_index(std::move(index)), true);
+  handle.attr("rows") = static_cast<double>(handle->rows());
+  handle.attr("dx_codes") = static_cast<double>(handle->dx_codes());
+  handle.attr("pc_codes") = static_cast<double>(handle->pc_codes());
+  handle.attr("bytes") = static_cast<double>(handle->bytes());
+  handle.attr("normalize") = handle->is_normalized();
+  handle.attr("class") = "pccc_index";
+  return handle;
+}
+
+static const code_index& index_of(SEXP x)
+{
+  if (TYPEOF(x) != EXTPTRSXP || !Rf_inherits(x, "pccc_index")) {
+    Rcpp::stop("index must be an index from ccc_index() or ccc_index_load().");
+  }
+  const code_index* index = static_cast<const code_index*>(R_ExternalPtrAddr(x));
+  if (!index) {
+    Rcpp::stop("The index is no longer loaded, as happens when it is saved and restored.  Use ccc_index_save() and ccc_index_load().");
+  }
+  return *index;
+}
+
+// The rows of one query term: a category, such as "cvd" or "ccc_flag", or a
+// code prefix, of diagnostic codes if written "dx:Q20", of procedure codes if
+// "pc:02H" and of either if "Q20".
+static row_bitmap term_rows(const code_index& index, const std::string& term)
+{
+  for (int b = 0; b < CCC_FLAG; ++b) {
+    if (term == codes::col_names[b]) {
+      return index.category_rows(b);
+    }
+  }
+  if (term == "ccc_flag") {
+    return index.category_rows(CCC_FLAG);
+  }
+
+  const std::string_view t(term);
+  if (t.substr(0, 3) == "dx:") {
+    return index.prefix_rows(t.substr(3), true, false);
+  }
+  if (t.substr(0, 3) == "pc:") {
+    return index.prefix_rows(t.substr(3), false, true);
+  }
+  return index.prefix_rows(t, true, true);
+}
+
+// Index the rows of code columns given as lists of character vectors and
+// factors, as for ccc_cols_rcpp, with mask the packed flags of each row from
+// ccc_cols_rcpp(output = "bitmask").
+// [[Rcpp::export]]
+SEXP ccc_index_rcpp(Rcpp::IntegerVector mask, Rcpp::List dx, Rcpp::List pc, bool normalize = false)
+{
+  const R_xlen_t nrow = mask.size();
+  if (nrow > INT_MAX) {
+    Rcpp::stop("An index can hold at most 2147483647 rows.");
+  }
+  const std::vector<code_column> dx_cols = list_columns(dx, nrow);
+  const std::vector<code_column> pc_cols = list_columns(pc, nrow);
+
+  code_index::builder builder(normalize);
+  std::vector<std::string_view> dx_views;
+  std::vector<std::string_view> pc_views;
+  std::vector<uint16_t> masks;
+
+  for (R_xlen_t begin = 0; begin < nrow; begin += ccc_index_batch) {
+    const R_xlen_t end = std::min(nrow, begin + ccc_index_batch);
+    masks.resize(end - begin);
+    for (R_xlen_t i = begin; i < end; ++i) {
+      if (mask[i] == NA_INTEGER || mask[i] < 0 || mask[i] >> (CCC_FLAG + 1)) {
+        Rcpp::stop("mask must hold CCC masks, as from ccc(output = \"bitmask\").");
+      }
+      masks[i - begin] = static_cast<uint16_t>(mask[i]);
+    }
+    fill_views(dx_views, dx_cols, begin, end);
+    fill_views(pc_views, pc_cols, begin, end);
+    builder.add_rows(masks.data(), dx_views.data(), dx_cols.size(),
+                     pc_views.data(), pc_cols.size(), end - begin);
+    Rcpp::checkUserInterrupt();
+  }
+
+  return index_handle(builder.finish());
+}
+
+// The 1-based rows with every term of all, any term of any, if given, and no
+// term of none.
+// [[Rcpp::export]]
+Rcpp::IntegerVector ccc_query_rcpp(SEXP index, Rcpp::CharacterVector all,
+                                   Rcpp::CharacterVector any, Rcpp::CharacterVector none)
+{
+  const code_index& idx = index_of(index);
+
+  row_bitmap rows;
+  if (all.size() > 0) {
+    rows = term_rows(idx, std::string(all[0]));
+    for (R_xlen_t k = 1; k < all.size(); ++k) {
+      rows = row_bitmap::and_of(rows, term_rows(idx, std::string(all[k])));
+    }
+  }
+  if (any.size() > 0) {
+    row_bitmap some = term_rows(idx, std::string(any[0]));
+    for (R_xlen_t k = 1; k < any.size(); ++k) {
+      some = row_bitmap::or_of(some, term_rows(idx, std::string(any[k])));
+    }
+    rows = all.size() > 0 ? row_bitmap::and_of(rows, some) : std::move(some);
+  }
+  if (all.size() == 0 && any.size() == 0) {
+    rows = idx.all_rows();
+  }
+  for (R_xlen_t k = 0; k < none.size(); ++k) {
+    rows = row_bitmap::and_not(rows, term_rows(idx, std::string(none[k])));
+  }
+
+  const std::vector<uint32_t> found = rows.rows();
+  Rcpp::IntegerVector out(found.size());
+  for (std::size_t i = 0; i < found.size(); ++i) {
+    out[i] = static_cast<int>(found[i]) + 1;
+  }
+  return out;
+}
+
+// [[Rcpp::export]]
+void ccc_index_save_rcpp(SEXP index, std::string file)
+{
+  index_of(index).save(file);
+}
+
+// [[Rcpp::export]]
+SEXP ccc_index_load_rcpp(std::string file)
+{
+  return index_handle(code_index::load(file));
+}
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <Rcpp.h>
+#include "pccc.h"
+#include "rcpp_groups.h"
+#include "rcpp_names.h"
+#include "rcpp_table.h"
+
+// CCC masks of the distinct codes seen so far, so that each distinct code is
+// looked up only once.  Character codes are kept in a mask_memo and factor
+// codes by their level.
+class code_memo {
+  private:
+    const codes& cdv;
+    mask_memo dx_strings;
+    mask_memo pc_strings;
+    std::vector<int32_t> dx_levels;
+    std::vector<int32_t> pc_levels;
+    SEXP levels;
+    bool normalize;
+
+    uint16_t lookup(SEXP s, bool pc) const {
+      std::string_view code(CHAR(s), LENGTH(s));
+      return pc ? cdv.match_pc(code, 0, normalize) : cdv.match_dx(code, 0, normalize);
+    };
+
+  public:
+    code_memo(const codes& c, SEXP code, bool norm) : cdv(c), levels(R_NilValue), normalize(norm) {
+      if (Rf_isFactor(code)) {
+        levels = Rf_getAttrib(code, R_LevelsSymbol);
+        dx_levels.assign(XLENGTH(levels), -1);
+        pc_levels.assign(XLENGTH(levels), -1);
+      }
+    };
+
+    uint16_t string_mask(SEXP s, bool pc) {
+      if (s == NA_STRING || LENGTH(s) == 0) {
+        return 0;
+      }
+      mask_memo& seen = pc ? pc_strings : dx_strings;
+      return seen.get(CHAR(s), [this, s, pc]() { return lookup(s, pc); });
+    };
+
+    uint16_t level_mask(int level, bool pc) {
+      if (level == NA_INTEGER) {
+        return 0;
+      }
+      int32_t& mask = (pc ? pc_levels : dx_levels)[level - 1];
+      if (mask < 0) {
+        SEXP s = STRING_ELT(levels, level - 1);
+        mask = LENGTH(s) == 0 ? 0 : lookup(s, pc);
+      }
+      return static_cast<uint16_t>(mask);
+    };
+};
+
+// [[Rcpp::export]]
+Rcpp::List ccc_long_rcpp(SEXP id, SEXP code, SEXP is_pc, SEXP version, bool sorted = false, bool normalize = false)
+{
+  const codes& cdv = codes_for(version);
+  const R_xlen_t n = XLENGTH(id);
+
+  if (XLENGTH(code) != n) {
+    Rcpp::stop("id and code must be the same length.");
+  }
+  if (!Rf_isNull(is_pc) && XLENGTH(is_pc) != n) {
+    Rcpp::stop("id and type must be the same length.");
+  }
+  if (TYPEOF(code) != STRSXP && !Rf_isFactor(code)) {
+    Rcpp::stop("code must be a character vector or a factor.");
+  }
+
+  std::vector<R_xlen_t> group;
+  std::vector<R_xlen_t> first;
+  group_ids(id, sorted, group, first);
+
+  // OR the masks of the codes of each group
+  code_memo memo(cdv, code, normalize);
+  std::vector<uint16_t> masks(first.size(), 0);
+  const int* pc_flags = Rf_isNull(is_pc) ? nullptr : LOGICAL(is_pc);
+
+  for (R_xlen_t i = 0; i < n; ++i) {
+    // codes of neither type are ignored
+    if (pc_flags && pc_flags[i] == NA_LOGICAL) {
+      continue;
+    }
+    const bool pc = pc_flags && pc_flags[i];
+    masks[group[i]] |= TYPEOF(code) == STRSXP
+      ? memo.string_mask(STRING_ELT(code, i), pc)
+      : memo.level_mask(INTEGER(code)[i], pc);
+    if ((i & 0xffff) == 0) {
+      Rcpp::checkUserInterrupt();
+    }
+  }
+
+  const R_xlen_t n_groups = first.size();
+  Rcpp::IntegerVector first_row(n_groups);
+  Rcpp::IntegerMatrix flags(n_groups, CCC_FLAG + 1);
+  int* out = INTEGER(flags);
+
+  for (R_xlen_t g = 0; g < n_groups; ++g) {
+    first_row[g] = first[g] + 1;
+    if (masks[g]) {
+      masks[g] |= 1 << CCC_FLAG;
+    }
+    for (int j = 0; j <= CCC_FLAG; ++j) {
+      out[j * n_groups + g] = (masks[g] >> j) & 1;
+    }
+  }
+
+  flags.attr("dimnames") = Rcpp::List::create(R_NilValue, category_names(true));
+
+  return Rcpp::List::create(Rcpp::Named("first") = first_row,
+                            Rcpp::Named("flags") = flags);
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <Rcpp.h>
+#include "pccc.h"
+#include "rcpp_groups.h"
+#include "task_group.h"
+
+// Bits of the masks which are tracked, the twelve categories and CCC_FLAG.
+static const int lookback_bits = CCC_FLAG + 1;
+
+// How many of the encounters in the window have each bit of their mask set.
+// Masks are added as encounters enter the window and removed as they leave,
+// so each encounter is added and removed once, whatever the window holds.
+class window_counts {
+  private:
+    uint32_t count[lookback_bits] = {};
+
+  public:
+    void add(int mask) {
+      for (int b = 0; mask >> b; ++b) {
+        count[b] += (mask >> b) & 1;
+      }
+    };
+
+    void remove(int mask) {
+      for (int b = 0; mask >> b; ++b) {
+        count[b] -= (mask >> b) & 1;
+      }
+    };
+
+    int mask() const {
+      int m = 0;
+      for (int b = 0; b < lookback_bits; ++b) {
+        m |= (count[b] > 0) << b;
+      }
+      return m;
+    };
+};
+
+// Sweep the encounters of one patient, rows[0, n) sorted by date, writing the
+// OR of the masks of the encounters no more than days before, and not after,
+// the date of each into out.  Rows with an NA date or mask are NA and are not
+// in any window; they are sorted last.
+static void sweep_patient(const R_xlen_t* rows, std::size_t n, const double* date,
+                          const int* mask, double days, bool include_current, int* out)
+{
+  window_counts window;
+  std::size_t enter = 0;
+  std::size_t leave = 0;
+
+  for (std::size_t p = 0; p < n; ++p) {
+    const R_xlen_t row = rows[p];
+    const double d = date[row];
+    if (ISNAN(d) || mask[row] == NA_INTEGER) {
+      out[row] = NA_INTEGER;
+      continue;
+    }
+    // every encounter on or before d, including later ones on the same day
+    while (enter < n && !ISNAN(date[rows[enter]]) && date[rows[enter]] <= d) {
+      if (mask[rows[enter]] != NA_INTEGER) {
+        window.add(mask[rows[enter]]);
+      }
+      ++enter;
+    }
+    while (date[rows[leave]] < d - days) {
+      if (mask[rows[leave]] != NA_INTEGER) {
+        window.remove(mask[rows[leave]]);
+      }
+      ++leave;
+    }
+    if (include_current) {
+      out[row] = window.mask();
+    } else {
+      window.remove(mask[row]);
+      out[row] = window.mask();
+      window.add(mask[row]);
+    }
+  }
+}
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector ccc_lookback_rcpp(SEXP id, Rcpp::NumericVector date, Rcpp::IntegerVector mask, double days, bool include_current = true, bool sorted = false, int n_threads = 1)
+{
+  const R_xlen_t n = XLENGTH(id);
+  if (date.size() != n || mask.size() != n) {
+    Rcpp::stop("id, date and mask must be the same length.");
+  }
+  if (ISNAN(days) || days < 0) {
+    Rcpp::stop("days must be a non-negative number.");
+  }
+  if (n_threads < 1) {
+    Rcpp::stop("n_threads must be a positive integer.");
+  }
+  const int* m = INTEGER(mask);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    if (m[i] != NA_INTEGER && (m[i] < 0 || m[i] >> lookback_bits)) {
+      Rcpp::stop("mask must hold CCC masks, as from ccc(output = \"bitmask\").");
+    }
+  }
+
+  std::vector<R_xlen_t> group;
+  std::vector<R_xlen_t> first;
+  group_ids(id, sorted, group, first);
+
+  // the rows of each patient, in row order, rows[start[g], start[g + 1])
+  const std::size_t n_groups = first.size();
+  std::vector<std::size_t> start(n_groups + 1, 0);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    ++start[group[i] + 1];
+  }
+  for (std::size_t g = 0; g < n_groups; ++g) {
+    start[g + 1] += start[g];
+  }
+  std::vector<R_xlen_t> rows(n);
+  std::vector<std::size_t> next(start.begin(), start.end() - 1);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    rows[next[group[i]]++] = i;
+  }
+  Rcpp::checkUserInterrupt();
+
+  Rcpp::IntegerVector out(n);
+  const double* d = REAL(date);
+  int* o = INTEGER(out);
+
+  // Each thread sorts and sweeps its own patients; no R API is used.
+  parallel_for(n_groups, n_threads, [&rows, &start, d, m, days, include_current, o](std::size_t begin, std::size_t end) {
+    auto earlier = [d](R_xlen_t a, R_xlen_t b) {
+      // NA dates last
+      return ISNAN(d[b]) ? !ISNAN(d[a]) : !ISNAN(d[a]) && d[a] < d[b];
+    };
+    for (std::size_t g = begin; g < end; ++g) {
+      R_xlen_t* r = rows.data() + start[g];
+      const std::size_t len = start[g + 1] - start[g];
+      std::stable_sort(r, r + len, earlier);
+      sweep_patient(r, len, d, m, days, include_current, o);
+    }
+  });
+
+  return out;
+}
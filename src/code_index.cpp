@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "code_index.h"
+
+// "PCCCIDX" and the version of the file layout
+static const char index_magic[8] = {'P', 'C', 'C', 'C', 'I', 'D', 'X', '1'};
+static const uint32_t byte_order_mark = 0x01020304;
+
+std::string code_index::normalize_code(std::string_view code)
+{
+  std::string out;
+  out.reserve(code.size());
+  for (char c : code) {
+    if (normalized_slots.slot[static_cast<unsigned char>(c)] == normalized_skip) {
+      continue;
+    }
+    out.push_back(c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c);
+  }
+  return out;
+}
+
+void code_index::builder::add_code(std::unordered_map<std::string, uint32_t>& ids,
+                                   std::vector<row_bitmap>& rows, std::string_view code,
+                                   uint32_t row)
+{
+  std::string key = normalize ? normalize_code(code) : std::string(code);
+  if (key.empty()) {
+    return;
+  }
+  auto it = ids.emplace(std::move(key), static_cast<uint32_t>(rows.size())).first;
+  if (it->second == rows.size()) {
+    rows.emplace_back();
+  }
+  rows[it->second].push_back(row);
+}
+
+void code_index::builder::add_rows(const uint16_t* masks, const std::string_view* dx,
+                                   std::size_t dx_ncol, const std::string_view* pc,
+                                   std::size_t pc_ncol, std::size_t n)
+{
+  if (n > UINT32_MAX - nrow) {
+    throw std::length_error("An index can hold at most 4294967295 rows.");
+  }
+
+  // row by row, so that the rows of each set are added in order
+  for (std::size_t i = 0; i < n; ++i) {
+    const uint32_t row = nrow + static_cast<uint32_t>(i);
+    for (int b = 0; masks[i] >> b; ++b) {
+      if ((masks[i] >> b) & 1) {
+        category[b].push_back(row);
+      }
+    }
+    for (std::size_t j = 0; j < dx_ncol; ++j) {
+      if (!dx[j * n + i].empty()) {
+        add_code(dx_ids, dx_rows, dx[j * n + i], row);
+      }
+    }
+    for (std::size_t j = 0; j < pc_ncol; ++j) {
+      if (!pc[j * n + i].empty()) {
+        add_code(pc_ids, pc_rows, pc[j * n + i], row);
+      }
+    }
+  }
+  nrow += static_cast<uint32_t>(n);
+}
+
+// The codes and their rows, sorted by code.
+static void sorted_codes(std::unordered_map<std::string, uint32_t>& ids,
+                         std::vector<row_bitmap>& rows,
+                         std::vector<std::pair<std::string, row_bitmap>>& out)
+{
+  out.clear();
+  out.reserve(ids.size());
+  for (auto& id : ids) {
+    out.emplace_back(id.first, std::move(rows[id.second]));
+  }
+  std::sort(out.begin(), out.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  ids.clear();
+  rows.clear();
+}
+
+code_index code_index::builder::finish()
+{
+  code_index index;
+  index.nrow = nrow;
+  index.normalized = normalize;
+  for (int b = 0; b <= CCC_FLAG; ++b) {
+    index.category[b] = std::move(category[b]);
+  }
+
+  std::vector<std::pair<std::string, row_bitmap>> codes;
+  sorted_codes(dx_ids, dx_rows, codes);
+  for (auto& c : codes) {
+    index.dx.push_back(code_rows{std::move(c.first), std::move(c.second)});
+  }
+  sorted_codes(pc_ids, pc_rows, codes);
+  for (auto& c : codes) {
+    index.pc.push_back(code_rows{std::move(c.first), std::move(c.second)});
+  }
+
+  nrow = 0;
+  return index;
+}
+
+std::size_t code_index::bytes() const
+{
+  std::size_t n = 0;
+  for (const row_bitmap& r : category) {
+    n += r.bytes();
+  }
+  for (const std::vector<code_rows>* codes : {&dx, &pc}) {
+    for (const code_rows& c : *codes) {
+      n += c.code.size() + c.rows.bytes();
+    }
+  }
+  return n;
+}
+
+row_bitmap code_index::all_rows() const
+{
+  row_bitmap out;
+  for (uint32_t i = 0; i < nrow; ++i) {
+    out.push_back(i);
+  }
+  return out;
+}
+
+// The union of the rows of the codes starting with prefix, taken in pairs so
+// that each row is copied about log2(codes) times rather than once per code.
+row_bitmap code_index::prefix_rows(const std::vector<code_rows>& codes,
+                                   std::string_view prefix) const
+{
+  auto first = std::lower_bound(codes.begin(), codes.end(), prefix,
+                                [](const code_rows& c, std::string_view p) { return c.code < p; });
+  auto last = first;
+  while (last != codes.end() && std::string_view(last->code).substr(0, prefix.size()) == prefix) {
+    ++last;
+  }
+
+  std::vector<row_bitmap> sets;
+  for (auto c = first; c + 1 < last; c += 2) {
+    sets.push_back(row_bitmap::or_of(c->rows, (c + 1)->rows));
+  }
+  if ((last - first) % 2) {
+    sets.push_back((last - 1)->rows);
+  }
+  while (sets.size() > 1) {
+    std::size_t k = 0;
+    for (std::size_t i = 0; i + 1 < sets.size(); i += 2) {
+      sets[k++] = row_bitmap::or_of(sets[i], sets[i + 1]);
+    }
+    if (sets.size() % 2) {
+      sets[k++] = std::move(sets.back());
+    }
+    sets.resize(k);
+  }
+
+  return sets.empty() ? row_bitmap() : std::move(sets[0]);
+}
+
+row_bitmap code_index::prefix_rows(std::string_view prefix, bool dx_codes, bool pc_codes) const
+{
+  const std::string p = normalized ? normalize_code(prefix) : std::string(prefix);
+  row_bitmap out = dx_codes ? prefix_rows(dx, p) : row_bitmap();
+  if (pc_codes) {
+    out = row_bitmap::or_of(out, prefix_rows(pc, p));
+  }
+  return out;
+}
+
+namespace {
+// Closes the file when it goes out of scope, as when an error is thrown.
+struct index_file {
+  std::FILE* f;
+  ~index_file() { if (f) std::fclose(f); };
+};
+}
+
+// The magic bytes, the byte order mark, the number of rows, whether the codes
+// are normalized, the category sets in bit order and then the number of dx
+// codes followed by each code, as its length and characters, and its set,
+// and the same for the pc codes.
+void code_index::save(const std::string& path) const
+{
+  index_file file{std::fopen(path.c_str(), "wb")};
+  if (!file.f) {
+    throw std::runtime_error("Unable to open '" + path + "' for writing.");
+  }
+
+  const uint32_t header[3] = {byte_order_mark, nrow, normalized ? 1u : 0u};
+  write_values(file.f, index_magic, sizeof index_magic);
+  write_values(file.f, header, 3);
+  for (const row_bitmap& r : category) {
+    r.write(file.f);
+  }
+  for (const std::vector<code_rows>* codes : {&dx, &pc}) {
+    const uint32_t n = static_cast<uint32_t>(codes->size());
+    write_values(file.f, &n, 1);
+    for (const code_rows& c : *codes) {
+      const uint32_t len = static_cast<uint32_t>(c.code.size());
+      write_values(file.f, &len, 1);
+      write_values(file.f, c.code.data(), len);
+      c.rows.write(file.f);
+    }
+  }
+
+  if (std::fclose(file.f) != 0) {
+    file.f = nullptr;
+    throw std::runtime_error("Error writing the index file.");
+  }
+  file.f = nullptr;
+}
+
+code_index code_index::load(const std::string& path)
+{
+  index_file file{std::fopen(path.c_str(), "rb")};
+  if (!file.f) {
+    throw std::runtime_error("Unable to open '" + path + "' for reading.");
+  }
+
+  char magic[sizeof index_magic];
+  uint32_t header[3];
+  if (std::fread(magic, 1, sizeof magic, file.f) != sizeof magic ||
+      std::memcmp(magic, index_magic, sizeof magic) != 0) {
+    throw std::runtime_error("'" + path + "' is not a CCC index file.");
+  }
+  read_values(file.f, header, 3);
+  if (header[0] != byte_order_mark) {
+    throw std::runtime_error("'" + path + "' was written on a machine of another byte order.");
+  }
+
+  code_index index;
+  index.nrow = header[1];
+  index.normalized = header[2] != 0;
+  for (row_bitmap& r : index.category) {
+    r = row_bitmap::read(file.f);
+  }
+  for (std::vector<code_rows>* codes : {&index.dx, &index.pc}) {
+    uint32_t n = 0;
+    read_values(file.f, &n, 1);
+    for (uint32_t i = 0; i < n; ++i) {
+      uint32_t len = 0;
+      read_values(file.f, &len, 1);
+      if (len > 1024) {
+        throw std::runtime_error("'" + path + "' is not a valid CCC index file.");
+      }
+      code_rows c;
+      c.code.resize(len);
+      read_values(file.f, &c.code[0], len);
+      c.rows = row_bitmap::read(file.f);
+      codes->push_back(std::move(c));
+    }
+  }
+
+  return index;
+}
@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "pccc.h"
+#include "row_bitmap.h"
+
+#ifndef CODE_INDEX_H
+#define CODE_INDEX_H
+
+// An inverted index over a classified dataset: for each CCC category, and for
+// each distinct diagnostic and procedure code, the set of rows in which it
+// occurs, as a row_bitmap.  Queries combine these sets, so that asking for
+// the rows with cvd and tech_dep but not transplant, or with any code under
+// Q20, touches only the sets concerned and not the data.  Prefix queries take
+// the union of the sets of the codes starting with the prefix, which are next
+// to each other since the codes are kept sorted.
+class code_index {
+  private:
+    struct code_rows {
+      std::string code;
+      row_bitmap rows;
+    };
+
+    uint32_t nrow;
+    bool normalized;
+    row_bitmap category[CCC_FLAG + 1];
+    std::vector<code_rows> dx;  // sorted by code
+    std::vector<code_rows> pc;
+
+    row_bitmap prefix_rows(const std::vector<code_rows>& codes, std::string_view prefix) const;
+
+  public:
+    // Builds an index from the rows of a dataset, a batch at a time and in
+    // row order.  Not thread safe.
+    class builder {
+      private:
+        uint32_t nrow;
+        bool normalize;
+        row_bitmap category[CCC_FLAG + 1];
+        std::unordered_map<std::string, uint32_t> dx_ids;
+        std::unordered_map<std::string, uint32_t> pc_ids;
+        std::vector<row_bitmap> dx_rows;
+        std::vector<row_bitmap> pc_rows;
+
+        void add_code(std::unordered_map<std::string, uint32_t>& ids,
+                      std::vector<row_bitmap>& rows, std::string_view code, uint32_t row);
+
+      public:
+        // With normalize, codes are indexed upper-cased and without dots or
+        // whitespace, as code_trie::match_normalized reads them.
+        explicit builder(bool normalize = false) : nrow(0), normalize(normalize) {};
+
+        // Add the next n rows: masks[i] holds the categories of row i, with
+        // CCC_FLAG, and its codes are laid out column by column, n views per
+        // column, as for codes::classify_columns.  Empty views are skipped.
+        // Throws std::length_error past 2^32 - 1 rows.
+        void add_rows(const uint16_t* masks, const std::string_view* dx, std::size_t dx_ncol,
+                      const std::string_view* pc, std::size_t pc_ncol, std::size_t n);
+
+        code_index finish();
+    };
+
+    code_index() : nrow(0), normalized(false) {};
+
+    uint32_t rows() const { return nrow; };
+    bool is_normalized() const { return normalized; };
+    std::size_t dx_codes() const { return dx.size(); };
+    std::size_t pc_codes() const { return pc.size(); };
+
+    // bytes taken by the row sets, for reporting
+    std::size_t bytes() const;
+
+    // every row of the dataset
+    row_bitmap all_rows() const;
+
+    // the rows with the category, 0 to CCC_FLAG, see ccc_category
+    const row_bitmap& category_rows(int b) const { return category[b]; };
+
+    // The rows with a diagnostic or procedure code, as asked, starting with
+    // prefix.  The prefix is normalized if the codes were.
+    row_bitmap prefix_rows(std::string_view prefix, bool dx_codes, bool pc_codes) const;
+
+    // Write the index to, or read it from, a file, in the byte order of this
+    // machine.  Throws std::runtime_error if the file cannot be opened, is
+    // not an index or was written on a machine of the other byte order.
+    void save(const std::string& path) const;
+    static code_index load(const std::string& path);
+
+    // a code upper-cased and without dots or whitespace
+    static std::string normalize_code(std::string_view code);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include <stdexcept>
+#include "code_trie.h"
+
+code_trie::code_trie() : nodes(1)
+{
+  nodes[0] = node();
+}
+
+void code_trie::insert(std::string_view code, uint16_t mask, bool fixed, uint32_t rule)
+{
+  if (code.empty()) {
+    throw std::invalid_argument("ICD codes in a code list must be non-empty.");
+  }
+
+  uint32_t n = 0;
+  nodes[n].subtree_mask |= mask;
+  for (std::size_t i = 0; i < code.size(); ++i) {
+    int s = slot(code[i]);
+    if (s < 0) {
+      throw std::invalid_argument("ICD code '" + std::string(code) + "' contains characters other than 0-9 and A-Z.");
+    }
+    if (nodes[n].child[s] == 0) {
+      nodes[n].child[s] = static_cast<uint32_t>(nodes.size());
+      nodes.push_back(node());
+    }
+    n = nodes[n].child[s];
+    nodes[n].subtree_mask |= mask;
+  }
+
+  if (fixed) {
+    nodes[n].fixed_mask |= mask;
+  } else {
+    nodes[n].prefix_mask |= mask;
+  }
+
+  if (rule != no_rule) {
+    if (rules.size() < nodes.size()) {
+      rules.resize(nodes.size());
+    }
+    rules[n].push_back(rule_ref{mask, fixed, rule});
+  }
+}
+
+uint16_t code_trie::explain(std::string_view code, uint32_t* rule, bool normalize) const
+{
+  uint16_t mask = 0;
+  uint32_t n = 0;
+
+  // the entries ending at node n, prefix or fixed, which add to mask
+  auto note = [this, &mask, rule](uint32_t at, bool fixed) {
+    uint16_t add = (fixed ? nodes[at].fixed_mask : nodes[at].prefix_mask) & ~mask;
+    if (add == 0) {
+      return;
+    }
+    if (at < rules.size()) {
+      for (const rule_ref& r : rules[at]) {
+        if (r.fixed != fixed) {
+          continue;
+        }
+        uint16_t set = add & r.mask;
+        for (int b = 0; set >> b; ++b) {
+          if ((set >> b) & 1) {
+            rule[b] = r.rule;
+          }
+        }
+        add &= ~set;
+      }
+    }
+    mask |= fixed ? nodes[at].fixed_mask : nodes[at].prefix_mask;
+  };
+
+  for (std::size_t i = 0; i < code.size(); ++i) {
+    int s = normalize ? slot_of<true>(code[i]) : slot(code[i]);
+    if (s == skip_byte) {
+      continue;
+    }
+    if (s < 0 || nodes[n].child[s] == 0) {
+      return mask;
+    }
+    n = nodes[n].child[s];
+    note(n, false);
+  }
+  note(n, true);
+  return mask;
+}
@@ -0,0 +1,175 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef CODE_TRIE_H
+#define CODE_TRIE_H
+
+// The trie slot of each byte for the normalized lookups of code_trie, or
+// normalized_skip for bytes which are skipped, or -1.
+const int normalized_skip = -2;
+
+struct normalized_slot_table {
+  signed char slot[256];
+};
+
+constexpr normalized_slot_table make_normalized_slots()
+{
+  normalized_slot_table t{};
+  for (int c = 0; c < 256; ++c) {
+    t.slot[c] = -1;
+  }
+  for (int c = 0; c < 10; ++c) {
+    t.slot['0' + c] = static_cast<signed char>(c);
+  }
+  for (int c = 0; c < 26; ++c) {
+    t.slot['A' + c] = static_cast<signed char>(c + 10);
+    t.slot['a' + c] = static_cast<signed char>(c + 10);
+  }
+  for (char c : {'.', ' ', '\t', '\n', '\r', '\v', '\f'}) {
+    t.slot[static_cast<unsigned char>(c)] = normalized_skip;
+  }
+  return t;
+}
+
+inline constexpr normalized_slot_table normalized_slots = make_normalized_slots();
+
+// A prefix trie over ICD codes.  Each node carries the bitmask of the CCC
+// categories whose code lists contain the string spelled out by the path from
+// the root to that node.  Prefix entries (the usual case) are stored in
+// prefix_mask and hit any patient code starting with them; "fixed" entries are
+// stored in fixed_mask and only hit when the patient code ends at that node.
+//
+// Each node also carries subtree_mask, the union of the masks of the node and
+// all of its descendants, so that a walk can stop as soon as nothing below the
+// current node could add a category that has not already been found.
+//
+// An entry may also be given a rule number, such as its position in a table of
+// all the entries, which explain() reports for each category it finds.
+//
+// ICD codes only use the characters 0-9 and A-Z, so each node has a dense
+// child table of 36 slots.  A patient code containing any other character
+// cannot be extended past that character.
+//
+// The normalized lookups instead read each byte of the patient code through a
+// 256 entry table which maps a-z to the slots of A-Z and skips '.' and
+// whitespace, so that "g80.1 " is looked up as "G801" without copying it.
+class code_trie {
+  private:
+    static const int alphabet_size = 36;
+
+    struct node {
+      uint16_t prefix_mask;
+      uint16_t fixed_mask;
+      uint16_t subtree_mask;
+      uint32_t child[alphabet_size];
+    };
+
+    // the rule numbers of the entries ending at a node, for the nodes which
+    // have any
+    struct rule_ref {
+      uint16_t mask;
+      bool fixed;
+      uint32_t rule;
+    };
+
+    std::vector<node> nodes;
+    std::vector<std::vector<rule_ref>> rules;
+
+    static int slot(unsigned char c) {
+      if (c >= '0' && c <= '9') {
+        return c - '0';
+      }
+      if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+      }
+      return -1;
+    }
+
+    static const int skip_byte = normalized_skip;
+
+    template <bool Normalize>
+    static int slot_of(char c) {
+      return Normalize ? normalized_slots.slot[static_cast<unsigned char>(c)] : slot(c);
+    }
+
+    // see match; with Count, each node visited is counted in visited, and with
+    // Normalize the code is read as described above
+    template <bool Count, bool Normalize = false>
+    uint16_t walk(const char* code, std::size_t len, uint16_t found, uint64_t* visited) const {
+      uint16_t mask = 0;
+      uint32_t n = 0;
+      for (std::size_t i = 0; i < len; ++i) {
+        int s = slot_of<Normalize>(code[i]);
+        if (Normalize && s == skip_byte) {
+          continue;
+        }
+        if (s < 0 || nodes[n].child[s] == 0) {
+          return mask;
+        }
+        n = nodes[n].child[s];
+        if (Count) {
+          ++*visited;
+        }
+        if ((nodes[n].subtree_mask & ~(found | mask)) == 0) {
+          return mask;
+        }
+        mask |= nodes[n].prefix_mask;
+      }
+      return mask | nodes[n].fixed_mask;
+    }
+
+  public:
+    static const uint32_t no_rule = UINT32_MAX;
+
+    code_trie();
+
+    void insert(std::string_view code, uint16_t mask, bool fixed, uint32_t rule = no_rule);
+
+    template <typename Codes>
+    void insert(const Codes& codes, uint16_t mask, bool fixed) {
+      for (std::string_view code : codes) {
+        insert(code, mask, fixed);
+      }
+    };
+
+    // Walk one patient code through the trie and return the union of the
+    // masks of every entry that matches it.  Bits already set in found are
+    // not searched for; the walk ends once no other bit can be reached.
+    uint16_t match(const char* code, std::size_t len, uint16_t found = 0) const {
+      return walk<false>(code, len, found, nullptr);
+    }
+
+    uint16_t match(std::string_view code, uint16_t found = 0) const {
+      return walk<false>(code.data(), code.size(), found, nullptr);
+    }
+
+    // As match(code, found), and also add the number of nodes visited below
+    // the root to visited.
+    uint16_t match(std::string_view code, uint16_t found, uint64_t& visited) const {
+      return walk<true>(code.data(), code.size(), found, &visited);
+    }
+
+    // As match, but with the code upper-cased and without dots or whitespace.
+    uint16_t match_normalized(std::string_view code, uint16_t found = 0) const {
+      return walk<false, true>(code.data(), code.size(), found, nullptr);
+    }
+
+    uint16_t match_normalized(std::string_view code, uint16_t found, uint64_t& visited) const {
+      return walk<true, true>(code.data(), code.size(), found, &visited);
+    }
+
+    // As match(code) but also set rule[b], for each bit b of the result, to
+    // the rule number of an entry which sets it: the shortest matching prefix
+    // entry, or else the fixed entry.  rule must have room for 16 numbers.
+    // With normalize the code is read as by match_normalized.
+    uint16_t explain(std::string_view code, uint32_t* rule, bool normalize = false) const;
+
+    // union of the masks of every entry in the trie
+    uint16_t reachable() const { return nodes[0].subtree_mask; };
+
+    std::size_t size() const { return nodes.size(); };
+};
+
+#endif
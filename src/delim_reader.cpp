@@ -0,0 +1,263 @@
+#include <stdexcept>
+#include "delim_reader.h"
+
+delim_reader::delim_reader(const std::string& path, char d, std::size_t b)
+  : file(path == "-" ? stdin : std::fopen(path.c_str(), "rb")), owns_file(path != "-"),
+    delim(d), block_size(b), at_eof(false)
+{
+  if (!file) {
+    throw std::runtime_error("Unable to open '" + path + "' for reading.");
+  }
+}
+
+delim_reader::~delim_reader()
+{
+  if (owns_file) {
+    std::fclose(file);
+  }
+}
+
+bool delim_reader::read_chunk(std::size_t max_records, delim_chunk& chunk)
+{
+  // pending always starts at the beginning of a record
+  std::string& data = chunk.data;
+  data.swap(pending);
+  pending.clear();
+
+  std::size_t pos = 0;
+  std::size_t end = 0;
+  std::size_t records = 0;
+  // Where the scan is within a field, as split_fields reads it: a quote
+  // opens a quoted field only at the start of a field and is literal
+  // elsewhere, and "" within a quoted field is an escaped quote.
+  enum { field_start, unquoted, quoted, quote_end } state = field_start;
+
+  while (records < max_records) {
+    for (; pos < data.size(); ++pos) {
+      char c = data[pos];
+      if (state == quoted) {
+        if (c == '"') {
+          state = quote_end;
+        }
+      } else if (c == '"' && (state == field_start || state == quote_end)) {
+        state = quoted;
+      } else if (c == delim) {
+        state = field_start;
+      } else if (c == '\n') {
+        state = field_start;
+        end = pos + 1;
+        if (++records == max_records) {
+          break;
+        }
+      } else {
+        state = unquoted;
+      }
+    }
+
+    if (records == max_records) {
+      break;
+    }
+
+    if (at_eof) {
+      // a last record without a trailing newline
+      if (end < data.size()) {
+        end = data.size();
+        ++records;
+      }
+      break;
+    }
+
+    std::size_t old_size = data.size();
+    data.resize(old_size + block_size);
+    std::size_t got = std::fread(&data[old_size], 1, block_size, file);
+    data.resize(old_size + got);
+    if (got < block_size) {
+      if (std::ferror(file)) {
+        throw std::runtime_error("Error reading the input file.");
+      }
+      at_eof = true;
+    }
+  }
+
+  pending.assign(data, end, std::string::npos);
+  data.resize(end);
+  split_fields(chunk);
+
+  return end > 0;
+}
+
+void delim_reader::split_fields(delim_chunk& chunk) const
+{
+  std::vector<std::string_view>& fields = chunk.fields;
+  std::vector<std::size_t>& record_begin = chunk.record_begin;
+  fields.clear();
+  record_begin.clear();
+
+  char* buf = &chunk.data[0];
+  const std::size_t n = chunk.data.size();
+  std::size_t i = 0;
+
+  while (i < n) {
+    // blank line
+    if (buf[i] == '\n' || (buf[i] == '\r' && i + 1 < n && buf[i + 1] == '\n')) {
+      i += buf[i] == '\n' ? 1 : 2;
+      continue;
+    }
+
+    record_begin.push_back(fields.size());
+
+    while (true) {
+      if (buf[i] == '"') {
+        // quoted field, unquoted in place: "" becomes "
+        std::size_t start = ++i;
+        std::size_t w = i;
+        while (i < n) {
+          if (buf[i] == '"') {
+            if (i + 1 < n && buf[i + 1] == '"') {
+              buf[w++] = '"';
+              i += 2;
+              continue;
+            }
+            ++i;
+            break;
+          }
+          buf[w++] = buf[i++];
+        }
+        fields.emplace_back(buf + start, w - start);
+        while (i < n && buf[i] != delim && buf[i] != '\n') {
+          ++i;
+        }
+      } else {
+        std::size_t start = i;
+        while (i < n && buf[i] != delim && buf[i] != '\n') {
+          ++i;
+        }
+        std::size_t stop = i;
+        if (stop > start && buf[stop - 1] == '\r') {
+          --stop;
+        }
+        fields.emplace_back(buf + start, stop - start);
+      }
+
+      if (i < n && buf[i] == delim) {
+        ++i;
+        continue;
+      }
+
+      // end of the record
+      if (i < n) {
+        ++i;
+      }
+      break;
+    }
+  }
+
+  if (!record_begin.empty()) {
+    record_begin.push_back(fields.size());
+  }
+}
+
+void split_line(const char* begin, const char* end, char delim,
+                std::vector<std::string_view>& fields)
+{
+  fields.clear();
+  if (end > begin && end[-1] == '\r') {
+    --end;
+  }
+
+  const char* p = begin;
+  while (true) {
+    if (p < end && *p == '"') {
+      const char* start = ++p;
+      while (p < end) {
+        if (*p == '"') {
+          if (p + 1 < end && p[1] == '"') {
+            p += 2;
+            continue;
+          }
+          break;
+        }
+        ++p;
+      }
+      fields.emplace_back(start, p - start);
+      while (p < end && *p != delim) {
+        ++p;
+      }
+    } else {
+      const char* start = p;
+      while (p < end && *p != delim) {
+        ++p;
+      }
+      fields.emplace_back(start, p - start);
+    }
+
+    if (p < end) {
+      ++p;
+    } else {
+      break;
+    }
+  }
+}
+
+std::string unquote(std::string_view field)
+{
+  std::string out(field);
+  std::size_t w = 0;
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    out[w++] = out[i];
+    if (out[i] == '"' && i + 1 < out.size() && out[i + 1] == '"') {
+      ++i;
+    }
+  }
+  out.resize(w);
+  return out;
+}
+
+std::vector<std::string> read_header(delim_reader& reader)
+{
+  delim_chunk chunk;
+  while (reader.read_chunk(1, chunk) && chunk.size() == 0) {
+  }
+
+  std::vector<std::string> header;
+  for (std::size_t j = 0; chunk.size() > 0 && j < chunk.n_fields(0); ++j) {
+    header.emplace_back(chunk.field(0, j));
+  }
+  return header;
+}
+
+void select_columns(std::string_view item, const std::vector<std::string>& header,
+                    std::vector<std::size_t>& cols)
+{
+  if (!item.empty() && item.back() == '*') {
+    const std::string_view prefix = item.substr(0, item.size() - 1);
+    for (std::size_t j = 0; j < header.size(); ++j) {
+      if (std::string_view(header[j]).substr(0, prefix.size()) == prefix) {
+        cols.push_back(j);
+      }
+    }
+    return;
+  }
+
+  std::size_t j = 0;
+  while (j < header.size() && header[j] != item) {
+    ++j;
+  }
+  if (j == header.size()) {
+    throw std::invalid_argument("Column '" + std::string(item) +
+                                "' was not found in the header of the input file.");
+  }
+  cols.push_back(j);
+}
+
+void chunk_views(const delim_chunk& chunk, const std::vector<std::size_t>& cols,
+                 std::vector<std::string_view>& views)
+{
+  const std::size_t n = chunk.size();
+  views.resize(n * cols.size());
+  for (std::size_t j = 0; j < cols.size(); ++j) {
+    for (std::size_t i = 0; i < n; ++i) {
+      views[j * n + i] = chunk.field(i, cols[j]);
+    }
+  }
+}
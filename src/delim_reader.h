@@ -0,0 +1,86 @@
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef DELIM_READER_H
+#define DELIM_READER_H
+
+// A block of records read from a delimited text file.  The raw bytes of the
+// records are held in data, with quoted fields unquoted in place, and every
+// field is a view into data.  Blank lines are dropped.
+class delim_chunk {
+  private:
+    std::string data;
+    std::vector<std::string_view> fields;
+    std::vector<std::size_t> record_begin;
+
+    friend class delim_reader;
+
+  public:
+    std::size_t size() const { return record_begin.empty() ? 0 : record_begin.size() - 1; };
+
+    std::size_t n_fields(std::size_t record) const {
+      return record_begin[record + 1] - record_begin[record];
+    };
+
+    // The j-th field of a record, or an empty view if the record is short.
+    std::string_view field(std::size_t record, std::size_t j) const {
+      return j < n_fields(record) ? fields[record_begin[record] + j] : std::string_view();
+    };
+};
+
+// Reads a delimited (csv, tsv, ...) file a fixed number of records at a time
+// so that memory use does not depend on the size of the file.  Fields may be
+// quoted with double quotes, following RFC 4180, in which case they may
+// contain the delimiter, newlines and doubled quotes.  The path "-" reads
+// standard input.
+class delim_reader {
+  private:
+    std::FILE* file;
+    bool owns_file;
+    char delim;
+    std::size_t block_size;
+    std::string pending;
+    bool at_eof;
+
+    void split_fields(delim_chunk& chunk) const;
+
+  public:
+    delim_reader(const std::string& path, char delim, std::size_t block_size = 1 << 20);
+    ~delim_reader();
+
+    delim_reader(const delim_reader&) = delete;
+    delim_reader& operator=(const delim_reader&) = delete;
+
+    // Replace the contents of chunk with up to max_records records.  Returns
+    // false once the end of the file has been reached and no records remain.
+    bool read_chunk(std::size_t max_records, delim_chunk& chunk);
+};
+
+// The fields of the first record of the file, its header, read past blank
+// lines.  Empty if the file has no records.
+std::vector<std::string> read_header(delim_reader& reader);
+
+// Add to cols the column of header named item or, if item ends in '*', every
+// column whose name starts with the rest of item, in header order.  Throws
+// std::invalid_argument if no column is named item.
+void select_columns(std::string_view item, const std::vector<std::string>& header,
+                    std::vector<std::size_t>& cols);
+
+// Views of the selected columns of a chunk, column by column.
+void chunk_views(const delim_chunk& chunk, const std::vector<std::size_t>& cols,
+                 std::vector<std::string_view>& views);
+
+// Split the line [begin, end), without its newline, into fields without copying
+// it.  Enclosing double quotes are dropped from quoted fields but doubled
+// quotes inside them are left as they are, see unquote().  A line split this
+// way cannot contain a quoted newline.
+void split_line(const char* begin, const char* end, char delim,
+                std::vector<std::string_view>& fields);
+
+// A field returned by split_line with its doubled quotes replaced by one.
+std::string unquote(std::string_view field);
+
+#endif
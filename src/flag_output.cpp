@@ -0,0 +1,93 @@
+#include "flag_output.h"
+#include "pccc.h"
+#include "task_group.h"
+
+const char* flag_name(int j)
+{
+  return j < CCC_FLAG ? codes::col_names[j] : "ccc_flag";
+}
+
+void append_field(std::string& line, std::string_view field, char delim)
+{
+  if (field.find_first_of(std::string{delim, '"', '\n', '\r'}) == std::string_view::npos) {
+    line.append(field);
+    return;
+  }
+  line.push_back('"');
+  for (char c : field) {
+    if (c == '"') {
+      line.push_back('"');
+    }
+    line.push_back(c);
+  }
+  line.push_back('"');
+}
+
+void append_header(std::string& lines, bool has_id, std::string_view id_name, char delim)
+{
+  if (has_id) {
+    append_field(lines, id_name, delim);
+    lines.push_back(delim);
+  }
+  for (int j = 0; j <= CCC_FLAG; ++j) {
+    lines.append(flag_name(j));
+    lines.push_back(j < CCC_FLAG ? delim : '\n');
+  }
+}
+
+void append_row(std::string& lines, bool has_id, std::string_view id,
+                uint16_t mask, char delim)
+{
+  if (has_id) {
+    append_field(lines, id, delim);
+    lines.push_back(delim);
+  }
+  for (int j = 0; j <= CCC_FLAG; ++j) {
+    lines.push_back((mask >> j) & 1 ? '1' : '0');
+    lines.push_back(j < CCC_FLAG ? delim : '\n');
+  }
+}
+
+void append_rows(std::string& lines, const delim_chunk& chunk, const uint16_t* masks,
+                 const std::vector<std::size_t>& id, char delim)
+{
+  for (std::size_t i = 0; i < chunk.size(); ++i) {
+    append_row(lines, !id.empty(), id.empty() ? std::string_view() : chunk.field(i, id[0]),
+               masks[i], delim);
+  }
+}
+
+void classify_stream(const codes& cdv, delim_reader& reader, const std::vector<std::size_t>& dx,
+                     const std::vector<std::size_t>& pc, std::size_t chunk_size, int n_threads,
+                     row_sink& sink)
+{
+  thread_pool workers(n_threads);
+  delim_chunk chunk;
+  std::vector<std::string_view> dx_views;
+  std::vector<std::string_view> pc_views;
+  std::vector<uint16_t> masks;
+
+  while (reader.read_chunk(chunk_size, chunk)) {
+    const std::size_t n = chunk.size();
+    if (n == 0) {
+      continue;
+    }
+
+    chunk_views(chunk, dx, dx_views);
+    chunk_views(chunk, pc, pc_views);
+    masks.assign(n, 0);
+
+    workers.start_parts(n, [&](int, std::size_t begin, std::size_t end) {
+      cdv.classify_columns(dx_views.data(), dx.size(), pc_views.data(), pc.size(),
+                           n, begin, end, masks.data());
+      for (std::size_t i = begin; i < end; ++i) {
+        if (masks[i]) {
+          masks[i] |= 1 << CCC_FLAG;
+        }
+      }
+    });
+    workers.wait();
+
+    sink.add_rows(chunk, masks.data());
+  }
+}
@@ -0,0 +1,51 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pccc.h"
+#include "delim_reader.h"
+
+#ifndef FLAG_OUTPUT_H
+#define FLAG_OUTPUT_H
+
+// Delimited text output of CCC flags, shared by ccc_file and the command line
+// tool.  Each row is the id, if any, then the 0/1 flags of the thirteen bits of
+// a CCC mask, see ccc_category.
+
+// Name of bit j of a CCC mask, as used for the output columns.
+const char* flag_name(int j);
+
+// Append a field to a line of delimited output, quoting it if needed.
+void append_field(std::string& line, std::string_view field, char delim);
+
+// Append the header line: the id column name, if any, and the flag names.
+void append_header(std::string& lines, bool has_id, std::string_view id_name, char delim);
+
+// Append one row of delimited output: the id, if any, and the CCC flags.
+void append_row(std::string& lines, bool has_id, std::string_view id,
+                uint16_t mask, char delim);
+
+// Append a row for each record of a chunk, with the id from column id[0], if
+// id is not empty, and masks[i] for record i.
+void append_rows(std::string& lines, const delim_chunk& chunk, const uint16_t* masks,
+                 const std::vector<std::size_t>& id, char delim);
+
+// Where classify_stream puts the rows it has classified, a chunk at a time.
+class row_sink {
+  public:
+    virtual ~row_sink() {};
+
+    // The records of the next chunk and the CCC mask of each, with CCC_FLAG.
+    virtual void add_rows(const delim_chunk& chunk, const uint16_t* masks) = 0;
+};
+
+// Classify the records of reader, after its header has been read, chunk_size
+// records at a time on n_threads threads, and pass each chunk to sink.  dx and
+// pc are the code columns, see select_columns.  Used by ccc_file and the
+// command line tool.
+void classify_stream(const codes& cdv, delim_reader& reader, const std::vector<std::size_t>& dx,
+                     const std::vector<std::size_t>& pc, std::size_t chunk_size, int n_threads,
+                     row_sink& sink);
+
+#endif
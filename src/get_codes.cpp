@@ -1,8 +1,21 @@
+#include <cinttypes>
+#include <cstdio>
 #include <string>
+#include <vector>
 #include <Rcpp.h>
 #include "pccc.h"
+#include "rcpp_names.h"
+#include "rcpp_table.h"
 
-const Rcpp::CharacterVector codes::col_names = Rcpp::CharacterVector::create("neuromusc", "cvd", "respiratory", "renal", "gi", "hemato_immu", "metabolic", "congeni_genetic", "malignancy", "neonatal", "tech_dep", "transplant");
+// Copy one of the static code tables into an R character vector.
+static Rcpp::CharacterVector code_vector(const code_list& codes)
+{
+  Rcpp::CharacterVector out(codes.size());
+  for (std::size_t i = 0; i < codes.size(); ++i) {
+    out[i] = Rf_mkCharLen(codes[i].data(), codes[i].size());
+  }
+  return out;
+}
 
 //' Get (view) Diagnostic and Procedure Codes
 //'
@@ -45,26 +58,26 @@ const Rcpp::CharacterVector codes::col_names = Rcpp::CharacterVector::create("ne
 //' @export
 // [[Rcpp::export]]
 Rcpp::List get_codes(int icdv) {
-  codes cds(icdv);
+  const codes& cds = codes::get(icdv);
 
   Rcpp::List dx = Rcpp::List::create(
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_neuromusc())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_cvd())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_respiratory())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_renal())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_gi())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_hemato_immu())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_metabolic())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_congeni_genetic())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_malignancy())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_neonatal())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_tech_dep())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_transplant())));
+          code_vector(cds.get_dx_neuromusc()),
+          code_vector(cds.get_dx_cvd()),
+          code_vector(cds.get_dx_respiratory()),
+          code_vector(cds.get_dx_renal()),
+          code_vector(cds.get_dx_gi()),
+          code_vector(cds.get_dx_hemato_immu()),
+          code_vector(cds.get_dx_metabolic()),
+          code_vector(cds.get_dx_congeni_genetic()),
+          code_vector(cds.get_dx_malignancy()),
+          code_vector(cds.get_dx_neonatal()),
+          code_vector(cds.get_dx_tech_dep()),
+          code_vector(cds.get_dx_transplant()));
 
   Rcpp::List dx_fixed = Rcpp::List::create(
-    Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_fixed_neuromusc())),
-    Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_fixed_cvd())),
-    Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_dx_fixed_respiratory())),
+    code_vector(cds.get_dx_fixed_neuromusc()),
+    code_vector(cds.get_dx_fixed_cvd()),
+    code_vector(cds.get_dx_fixed_respiratory()),
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
@@ -76,18 +89,18 @@ Rcpp::List get_codes(int icdv) {
     Rcpp::CharacterVector::create());
 
   Rcpp::List pc = Rcpp::List::create(
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_neuromusc())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_cvd())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_respiratory())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_renal())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_gi())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_hemato_immu())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_metabolic())),
+          code_vector(cds.get_pc_neuromusc()),
+          code_vector(cds.get_pc_cvd()),
+          code_vector(cds.get_pc_respiratory()),
+          code_vector(cds.get_pc_renal()),
+          code_vector(cds.get_pc_gi()),
+          code_vector(cds.get_pc_hemato_immu()),
+          code_vector(cds.get_pc_metabolic()),
           Rcpp::CharacterVector::create(),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_malignancy())),
+          code_vector(cds.get_pc_malignancy()),
           Rcpp::CharacterVector::create(),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_tech_dep())),
-          Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_transplant())));
+          code_vector(cds.get_pc_tech_dep()),
+          code_vector(cds.get_pc_transplant()));
 
   Rcpp::List pc_fixed = Rcpp::List::create(
     Rcpp::CharacterVector::create(),
@@ -96,7 +109,7 @@ Rcpp::List get_codes(int icdv) {
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
-    Rcpp::Shield<SEXP>(Rcpp::wrap(cds.get_pc_fixed_metabolic())),
+    code_vector(cds.get_pc_fixed_metabolic()),
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
     Rcpp::CharacterVector::create(),
@@ -115,10 +128,106 @@ Rcpp::List get_codes(int icdv) {
   rtn.attr("version") = icdv;
   rtn.attr("dim") = Rcpp::NumericVector::create(12, 4);
   rtn.attr("dimnames") = Rcpp::List::create(
-      codes::col_names,
+      category_names(),
       Rcpp::CharacterVector::create("dx", "dx_fixed", "pc", "pc_fixed")
       );
   rtn.attr("class") = "pccc_codes";
 
   return(rtn);
 }
+
+//' CCC Rules
+//'
+//' Every entry of the CCC code lists for an ICD version, numbered.
+//'
+//' These are the codes returned by \code{\link{get_codes}}, one per row.  The
+//' \code{rule} numbers are those reported by \code{ccc(..., explain = TRUE)};
+//' see \code{\link{ccc_explain}}.  A patient code matches an entry when the
+//' entry is a prefix of it, or, for \code{fixed} entries, when the two are
+//' equal.
+//'
+//' @param icdv and integer value specifying ICD version.  Accepted values are 9
+//' or 10.  Or a code table from \code{\link{ccc_table}}.
+//'
+//' @return
+//' A \code{data.frame} with columns \code{rule}, \code{type} (\code{"dx"} or
+//' \code{"pc"}), \code{category}, \code{fixed} and \code{code}.
+//'
+//' @seealso \code{\link{get_codes}}, \code{\link{ccc_explain}},
+//' \code{\link{ccc_table}}
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List ccc_rules(SEXP icdv)
+{
+  const std::vector<code_rule>& rules = codes_for(icdv).get_rules();
+  const R_xlen_t n = rules.size();
+
+  Rcpp::IntegerVector rule(n);
+  Rcpp::CharacterVector type(n);
+  Rcpp::CharacterVector category(n);
+  Rcpp::LogicalVector fixed(n);
+  Rcpp::CharacterVector code(n);
+
+  for (R_xlen_t i = 0; i < n; ++i) {
+    rule[i] = i + 1;
+    type[i] = rules[i].pc ? "pc" : "dx";
+    category[i] = codes::col_names[rules[i].category];
+    fixed[i] = rules[i].fixed;
+    code[i] = Rf_mkCharLen(rules[i].code.data(), rules[i].code.size());
+  }
+
+  Rcpp::List out = Rcpp::List::create(Rcpp::Named("rule") = rule,
+                                      Rcpp::Named("type") = type,
+                                      Rcpp::Named("category") = category,
+                                      Rcpp::Named("fixed") = fixed,
+                                      Rcpp::Named("code") = code);
+  out.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -n);
+  out.attr("class") = "data.frame";
+  return out;
+}
+
+// [[Rcpp::export]]
+SEXP ccc_table_rcpp(Rcpp::CharacterVector type, Rcpp::CharacterVector category,
+                    Rcpp::LogicalVector fixed, Rcpp::CharacterVector code)
+{
+  const R_xlen_t n = code.size();
+  if (type.size() != n || category.size() != n || fixed.size() != n) {
+    Rcpp::stop("type, category, fixed and code must be the same length.");
+  }
+
+  std::vector<code_entry> table(n);
+  for (R_xlen_t i = 0; i < n; ++i) {
+    if (code[i] == NA_STRING || type[i] == NA_STRING || category[i] == NA_STRING ||
+        fixed[i] == NA_LOGICAL) {
+      Rcpp::stop("Entry " + std::to_string(i + 1) + " of the code table has a missing value.");
+    }
+
+    const std::string t(type[i]);
+    if (t != "dx" && t != "pc") {
+      Rcpp::stop("The type of entry " + std::to_string(i + 1) + " must be 'dx' or 'pc'.");
+    }
+
+    const std::string c(category[i]);
+    int j = 0;
+    while (j < CCC_FLAG && c != codes::col_names[j]) {
+      ++j;
+    }
+    if (j == CCC_FLAG) {
+      Rcpp::stop("Unknown category '" + c + "' in entry " + std::to_string(i + 1) + " of the code table.");
+    }
+
+    table[i] = code_entry{std::string(code[i]), j, t == "pc", fixed[i] != 0};
+  }
+
+  bool cached = false;
+  Rcpp::XPtr<code_table> handle(new code_table(codes::get(table, &cached)), true);
+
+  char hash[17];
+  std::snprintf(hash, sizeof hash, "%016" PRIx64, (*handle)->get_hash());
+  handle.attr("hash") = std::string(hash);
+  handle.attr("entries") = static_cast<double>(n);
+  handle.attr("cached") = cached;
+  handle.attr("class") = "pccc_table";
+  return handle;
+}
@@ -0,0 +1,91 @@
+#include <stdexcept>
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+mapped_file::mapped_file(const std::string& path)
+  : first(nullptr), n(0), file_handle(INVALID_HANDLE_VALUE), mapping_handle(nullptr)
+{
+  file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Unable to open '" + path + "' for reading.");
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_handle, &size)) {
+    CloseHandle(file_handle);
+    throw std::runtime_error("Unable to get the size of '" + path + "'.");
+  }
+  n = static_cast<std::size_t>(size.QuadPart);
+
+  if (n > 0) {
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle) {
+      first = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!first) {
+      if (mapping_handle) {
+        CloseHandle(mapping_handle);
+      }
+      CloseHandle(file_handle);
+      throw std::runtime_error("Unable to map '" + path + "' into memory.");
+    }
+  }
+}
+
+mapped_file::~mapped_file()
+{
+  if (first) {
+    UnmapViewOfFile(first);
+  }
+  if (mapping_handle) {
+    CloseHandle(mapping_handle);
+  }
+  CloseHandle(file_handle);
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+mapped_file::mapped_file(const std::string& path)
+  : first(nullptr), n(0)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Unable to open '" + path + "' for reading.");
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Unable to get the size of '" + path + "'.");
+  }
+  n = static_cast<std::size_t>(st.st_size);
+
+  if (n > 0) {
+    void* p = mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Unable to map '" + path + "' into memory.");
+    }
+    // the file is read front to back
+    madvise(p, n, MADV_SEQUENTIAL);
+    first = static_cast<const char*>(p);
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+  if (first) {
+    munmap(const_cast<char*>(first), n);
+  }
+}
+#endif
@@ -0,0 +1,28 @@
+#include <cstddef>
+#include <string>
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+// A file mapped read-only into memory for the life of the object.
+class mapped_file {
+  private:
+    const char* first;
+    std::size_t n;
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#endif
+
+  public:
+    explicit mapped_file(const std::string& path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const char* data() const { return first; };
+    std::size_t size() const { return n; };
+};
+
+#endif
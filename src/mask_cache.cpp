@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "code_trie.h"
+#include "mask_cache.h"
+
+// "PCCCMSK" and the version of the file layout
+static const char cache_magic[8] = {'P', 'C', 'C', 'C', 'M', 'S', 'K', '1'};
+static const uint32_t byte_order_mark = 0x01020304;
+
+// the finalizer of splitmix64, so that sums of hashes stay well mixed
+static uint64_t mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static bool entry_less(const cache_entry& a, const cache_entry& b)
+{
+  return a.id < b.id || (a.id == b.id && a.codes < b.codes);
+}
+
+static bool entry_same(const cache_entry& a, const cache_entry& b)
+{
+  return a.id == b.id && a.codes == b.codes;
+}
+
+mask_cache::mask_cache(std::vector<cache_entry> e) : entries(std::move(e))
+{
+  std::stable_sort(entries.begin(), entries.end(), entry_less);
+  entries.erase(std::unique(entries.begin(), entries.end(), entry_same), entries.end());
+}
+
+mask_cache::lookup mask_cache::find(uint64_t id, uint64_t codes, uint16_t& mask) const
+{
+  auto it = std::lower_bound(entries.begin(), entries.end(), cache_entry{id, codes, 0}, entry_less);
+  if (it != entries.end() && it->id == id && it->codes == codes) {
+    mask = it->mask;
+    return found;
+  }
+  // entries with the id, if any, are next to where the row would be
+  if ((it != entries.end() && it->id == id) || (it != entries.begin() && (it - 1)->id == id)) {
+    return changed;
+  }
+  return added;
+}
+
+uint64_t mask_cache::id_hash(const void* data, std::size_t size)
+{
+  uint64_t h = 14695981039346656037ULL;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+  return mix(h);
+}
+
+// FNV-1a of one code, read as the trie reads it
+static uint64_t code_hash(std::string_view code, bool normalize)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (char c : code) {
+    if (normalize) {
+      if (normalized_slots.slot[static_cast<unsigned char>(c)] == normalized_skip) {
+        continue;
+      }
+      if (c >= 'a' && c <= 'z') {
+        c = static_cast<char>(c - 'a' + 'A');
+      }
+    }
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ULL;
+  }
+  return mix(h);
+}
+
+uint64_t mask_cache::codes_hash(const std::string_view* dx, std::size_t dx_ncol,
+                                const std::string_view* pc, std::size_t pc_ncol,
+                                std::size_t stride, std::size_t i, uint64_t table_hash,
+                                bool normalize)
+{
+  // sums, so that the order of the codes does not matter
+  uint64_t dx_sum = 0;
+  uint64_t pc_sum = 0;
+  for (std::size_t j = 0; j < dx_ncol; ++j) {
+    if (!dx[j * stride + i].empty()) {
+      dx_sum += code_hash(dx[j * stride + i], normalize);
+    }
+  }
+  for (std::size_t j = 0; j < pc_ncol; ++j) {
+    if (!pc[j * stride + i].empty()) {
+      pc_sum += code_hash(pc[j * stride + i], normalize);
+    }
+  }
+
+  uint64_t h = mix(dx_sum);
+  h = mix(h ^ pc_sum);
+  h = mix(h ^ table_hash);
+  return mix(h ^ (normalize ? 1 : 0));
+}
+
+namespace {
+// Closes the file when it goes out of scope, as when an error is thrown.
+struct cache_file {
+  std::FILE* f;
+  ~cache_file() { if (f) std::fclose(f); };
+};
+}
+
+template <typename T>
+static void write_values(std::FILE* out, const T* x, std::size_t n)
+{
+  if (std::fwrite(x, sizeof(T), n, out) != n) {
+    throw std::runtime_error("Error writing the cache file.");
+  }
+}
+
+template <typename T>
+static void read_values(std::FILE* in, T* x, std::size_t n)
+{
+  if (std::fread(x, sizeof(T), n, in) != n) {
+    throw std::runtime_error("The cache file is truncated.");
+  }
+}
+
+// The magic bytes, the byte order mark, the number of entries and then their
+// ids, codes and masks, each as one array.
+void mask_cache::save(const std::string& path) const
+{
+  const std::string temp = path + ".tmp";
+  cache_file file{std::fopen(temp.c_str(), "wb")};
+  if (!file.f) {
+    throw std::runtime_error("Unable to open '" + temp + "' for writing.");
+  }
+
+  const uint64_t n = entries.size();
+  std::vector<uint64_t> column(n);
+  std::vector<uint16_t> masks(n);
+  write_values(file.f, cache_magic, sizeof cache_magic);
+  write_values(file.f, &byte_order_mark, 1);
+  write_values(file.f, &n, 1);
+  for (std::size_t i = 0; i < n; ++i) {
+    column[i] = entries[i].id;
+  }
+  write_values(file.f, column.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    column[i] = entries[i].codes;
+    masks[i] = entries[i].mask;
+  }
+  write_values(file.f, column.data(), n);
+  write_values(file.f, masks.data(), n);
+
+  const int closed = std::fclose(file.f);
+  file.f = nullptr;
+  if (closed != 0) {
+    std::remove(temp.c_str());
+    throw std::runtime_error("Error writing the cache file.");
+  }
+  // rename does not replace an existing file everywhere
+  if (std::rename(temp.c_str(), path.c_str()) != 0 &&
+      (std::remove(path.c_str()) != 0 || std::rename(temp.c_str(), path.c_str()) != 0)) {
+    throw std::runtime_error("Unable to replace the cache file '" + path + "'.");
+  }
+}
+
+mask_cache mask_cache::load(const std::string& path)
+{
+  cache_file file{std::fopen(path.c_str(), "rb")};
+  if (!file.f) {
+    return mask_cache();
+  }
+
+  char magic[sizeof cache_magic];
+  uint32_t bom = 0;
+  if (std::fread(magic, 1, sizeof magic, file.f) != sizeof magic ||
+      std::memcmp(magic, cache_magic, sizeof magic) != 0) {
+    throw std::runtime_error("'" + path + "' is not a CCC cache file.");
+  }
+  read_values(file.f, &bom, 1);
+  if (bom != byte_order_mark) {
+    return mask_cache();
+  }
+
+  uint64_t n = 0;
+  read_values(file.f, &n, 1);
+
+  // the entries must fill the rest of the file exactly, so that a corrupt
+  // count cannot ask for more memory than the file holds
+  const long start = std::ftell(file.f);
+  if (start < 0 || std::fseek(file.f, 0, SEEK_END) != 0) {
+    throw std::runtime_error("Error reading '" + path + "'.");
+  }
+  const long stop = std::ftell(file.f);
+  if (stop < start || std::fseek(file.f, start, SEEK_SET) != 0) {
+    throw std::runtime_error("Error reading '" + path + "'.");
+  }
+  const uint64_t entry_bytes = 2 * sizeof(uint64_t) + sizeof(uint16_t);
+  const uint64_t remaining = static_cast<uint64_t>(stop - start);
+  if (n > remaining / entry_bytes || remaining != n * entry_bytes) {
+    throw std::runtime_error("'" + path + "' is not a valid CCC cache file.");
+  }
+  std::vector<uint64_t> column(n);
+  std::vector<uint16_t> masks(n);
+  mask_cache cache;
+  cache.entries.resize(n);
+  read_values(file.f, column.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    cache.entries[i].id = column[i];
+  }
+  read_values(file.f, column.data(), n);
+  read_values(file.f, masks.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    cache.entries[i].codes = column[i];
+    cache.entries[i].mask = masks[i];
+  }
+
+  // as saved, unless the file was written otherwise
+  if (!std::is_sorted(cache.entries.begin(), cache.entries.end(), entry_less)) {
+    return mask_cache(std::move(cache.entries));
+  }
+  return cache;
+}
@@ -0,0 +1,71 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef MASK_CACHE_H
+#define MASK_CACHE_H
+
+// The category mask of one row of an earlier run, keyed by a hash of the
+// row's id and a hash of its codes and of the code tables which classified
+// them, see mask_cache::codes_hash.
+struct cache_entry {
+  uint64_t id;
+  uint64_t codes;
+  uint16_t mask;
+};
+
+// The masks of the rows of an earlier run, kept in a file, for incremental
+// runs over a table most of whose rows are the same from run to run.  A row
+// is found only if its id, its codes and the code tables are all unchanged;
+// since the tables of the built-in ICD versions are hashed with their
+// entries, changing the code lists in pccc.cpp misses every row of the
+// cache.  Lookups do not modify the cache and may be made from many threads.
+class mask_cache {
+  private:
+    std::vector<cache_entry> entries;  // sorted by id, then codes
+
+  public:
+    enum lookup { found, changed, added };
+
+    mask_cache() {};
+
+    // A cache of entries, which need not be sorted.  Of entries with the
+    // same id and codes only the first is kept.
+    explicit mask_cache(std::vector<cache_entry> entries);
+
+    std::size_t size() const { return entries.size(); };
+
+    // Look up the row with the id and codes hashes.  If found, mask is set to
+    // its mask; otherwise the row is either changed, there are entries with
+    // its id but none with its codes, or added.
+    lookup find(uint64_t id, uint64_t codes, uint16_t& mask) const;
+
+    // Read a cache written by save, or an empty cache if the file does not
+    // exist or was written on a machine of the other byte order.  Throws
+    // std::runtime_error if the file is not a cache or its size does not
+    // match the number of entries in its header.
+    static mask_cache load(const std::string& path);
+
+    // Write the cache to a temporary file beside path and rename it to path,
+    // so that an interrupted run leaves the old cache in place.  Throws
+    // std::runtime_error if the file cannot be written.
+    void save(const std::string& path) const;
+
+    // 64-bit hash of the bytes of an id.
+    static uint64_t id_hash(const void* data, std::size_t size);
+
+    // Hash of the codes of row i of a block laid out column by column,
+    // stride views per column, as for codes::classify_columns, and of
+    // table_hash, the codes::get_hash() of the tables for the row.  The
+    // order of the codes does not matter, and empty views are skipped.  With
+    // normalize the codes are hashed as code_trie::match_normalized reads
+    // them, so "g80.1" and "G801" hash alike.
+    static uint64_t codes_hash(const std::string_view* dx, std::size_t dx_ncol,
+                               const std::string_view* pc, std::size_t pc_ncol,
+                               std::size_t stride, std::size_t i, uint64_t table_hash,
+                               bool normalize);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef MASK_MEMO_H
+#define MASK_MEMO_H
+
+// The category masks of codes which have already been matched, keyed by the
+// address of the code's characters.  R keeps one CHARSXP for all equal
+// strings in its global string cache, so codes read from a character vector
+// with CHAR() have the same address exactly when they are the same code, and
+// each distinct code is matched only once.  Keys must stay valid, and keep
+// their contents, for the life of the memo.  Not thread safe; each thread
+// keeps its own.
+class mask_memo {
+  private:
+    struct slot {
+      const char* key;
+      uint16_t mask;
+    };
+
+    std::vector<slot> slots;
+    std::size_t used;
+    std::size_t hits;
+    std::size_t misses;
+    int shift;
+
+    std::size_t index(const char* key) const {
+      return static_cast<std::size_t>(
+        (reinterpret_cast<std::uintptr_t>(key) * UINT64_C(0x9E3779B97F4A7C15)) >> shift);
+    };
+
+    void grow() {
+      std::vector<slot> old(slots.size() * 2, slot{nullptr, 0});
+      old.swap(slots);
+      --shift;
+      const std::size_t m = slots.size() - 1;
+      for (const slot& s : old) {
+        if (s.key) {
+          std::size_t i = index(s.key);
+          while (slots[i].key) {
+            i = (i + 1) & m;
+          }
+          slots[i] = s;
+        }
+      }
+    };
+
+  public:
+    mask_memo() : slots(1024, slot{nullptr, 0}), used(0), hits(0), misses(0), shift(64 - 10) {};
+
+    // The mask of the code at key, calling match() to find it the first time.
+    template <typename Match>
+    uint16_t get(const char* key, Match match) {
+      const std::size_t m = slots.size() - 1;
+      std::size_t i = index(key);
+      while (slots[i].key) {
+        if (slots[i].key == key) {
+          ++hits;
+          return slots[i].mask;
+        }
+        i = (i + 1) & m;
+      }
+
+      ++misses;
+      uint16_t mask = match();
+      slots[i] = slot{key, mask};
+      if (++used * 2 > slots.size()) {
+        grow();
+      }
+      return mask;
+    };
+
+    std::size_t get_hits() const { return hits; };
+    std::size_t get_misses() const { return misses; };
+};
+
+#endif
@@ -1,59 +1,225 @@
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <Rcpp.h>
+#include <string_view>
+#include <vector>
+#include "code_trie.h"
+#include "mask_memo.h"
 
 #ifndef PCCC_H
 #define PCCC_H
 
+// One entry of one of the code lists.  Entries are numbered, from 0, in the
+// order of codes::get_rules(), and code_trie::explain reports these numbers.
+struct code_rule {
+  std::string_view code;
+  int category;
+  bool pc;
+  bool fixed;
+};
+
+// One entry of a user-supplied code table, see codes::get(const
+// std::vector<code_entry>&).  Unlike code_rule it owns its code.
+struct code_entry {
+  std::string code;
+  int category;
+  bool pc;
+  bool fixed;
+};
+
+// A read-only view of one of the static, constexpr code tables in pccc.cpp.
+class code_list {
+  private:
+    const std::string_view* first;
+    std::size_t n;
+
+  public:
+    constexpr code_list() : first(nullptr), n(0) {};
+
+    template <std::size_t N>
+    constexpr code_list(const std::string_view (&codes)[N]) : first(codes), n(N) {};
+
+    const std::string_view* begin() const { return first; };
+    const std::string_view* end() const { return first + n; };
+    std::size_t size() const { return n; };
+    const std::string_view& operator[](std::size_t i) const { return first[i]; };
+};
+
+// Bit positions of the CCC categories in the masks stored in the code tries
+// and returned by codes::classify.  The order matches codes::col_names, with
+// CCC_FLAG set whenever any of the twelve categories is.
+enum ccc_category {
+  CCC_NEUROMUSC = 0,
+  CCC_CVD,
+  CCC_RESPIRATORY,
+  CCC_RENAL,
+  CCC_GI,
+  CCC_HEMATO_IMMU,
+  CCC_METABOLIC,
+  CCC_CONGENI_GENETIC,
+  CCC_MALIGNANCY,
+  CCC_NEONATAL,
+  CCC_TECH_DEP,
+  CCC_TRANSPLANT,
+  CCC_FLAG
+};
+
+// Counts of the work done by codes::classify_columns and
+// codes::explain_columns, added to as they go.  A code is looked up in the
+// trie, or in the memo, unless its row already has every category the code
+// could add, in which case it is skipped.
+struct classify_stats {
+  uint64_t cells = 0;            // cells visited, empty or not
+  uint64_t codes = 0;            // cells with a code
+  uint64_t skipped = 0;          // codes not looked up
+  uint64_t lookups = 0;          // codes looked up
+  uint64_t nodes = 0;            // trie nodes visited by the lookups
+  uint64_t tests[CCC_FLAG] = {}; // lookups made while each category was still to find
+  uint64_t hits[CCC_FLAG] = {};  // rows in which each category was found
+
+  void add(const classify_stats& other);
+};
+
 class codes {
   private:
     int version;
 
-    std::vector<std::string> dx_neuromusc;
-    std::vector<std::string> dx_fixed_neuromusc;
-    std::vector<std::string> dx_cvd;
-    std::vector<std::string> dx_fixed_cvd;
-    std::vector<std::string> dx_respiratory;
-    std::vector<std::string> dx_fixed_respiratory;
-    std::vector<std::string> dx_renal;
-    std::vector<std::string> dx_gi;
-    std::vector<std::string> dx_hemato_immu;
-    std::vector<std::string> dx_metabolic;
-    std::vector<std::string> dx_congeni_genetic;
-    std::vector<std::string> dx_malignancy;
-    std::vector<std::string> dx_neonatal;
-    std::vector<std::string> dx_tech_dep;
-    std::vector<std::string> dx_transplant;
-
-    std::vector<std::string> pc_neuromusc;
-    std::vector<std::string> pc_cvd;
-    std::vector<std::string> pc_respiratory;
-    std::vector<std::string> pc_renal;
-    std::vector<std::string> pc_gi;
-    std::vector<std::string> pc_hemato_immu;
-    std::vector<std::string> pc_metabolic;
-    std::vector<std::string> pc_fixed_metabolic;
+    code_list dx_neuromusc;
+    code_list dx_fixed_neuromusc;
+    code_list dx_cvd;
+    code_list dx_fixed_cvd;
+    code_list dx_respiratory;
+    code_list dx_fixed_respiratory;
+    code_list dx_renal;
+    code_list dx_gi;
+    code_list dx_hemato_immu;
+    code_list dx_metabolic;
+    code_list dx_congeni_genetic;
+    code_list dx_malignancy;
+    code_list dx_neonatal;
+    code_list dx_tech_dep;
+    code_list dx_transplant;
+
+    code_list pc_neuromusc;
+    code_list pc_cvd;
+    code_list pc_respiratory;
+    code_list pc_renal;
+    code_list pc_gi;
+    code_list pc_hemato_immu;
+    code_list pc_metabolic;
+    code_list pc_fixed_metabolic;
     // there are currently no procedure codes for this CCC
-    //std::vector<std::string> pc_congeni_genetic;
-    std::vector<std::string> pc_malignancy;
+    //code_list pc_congeni_genetic;
+    code_list pc_malignancy;
     // there are currently no procedure codes for this CCC
-    //std::vector<std::string> pc_neonatal;
-    std::vector<std::string> pc_tech_dep;
-    std::vector<std::string> pc_transplant;
+    //code_list pc_neonatal;
+    code_list pc_tech_dep;
+    code_list pc_transplant;
 
     const std::vector<std::string> empty;
 
-    int find_match(const std::vector<std::string>& dx,
-                   const std::vector<std::string>& pc,
-                   const std::vector<std::string>& dx_codes,
-                   const std::vector<std::string>& pc_codes);
+    // all of the dx and pc code lists above, compiled into one trie each
+    code_trie dx_trie;
+    code_trie pc_trie;
+
+    // every entry of the code lists, numbered as inserted into the tries
+    std::vector<code_rule> rules;
 
-    int find_fixed_match(const std::vector<std::string>& input,
-                         const std::vector<std::string>& ccc);
+    // The codes of a user-supplied table, one after the other, which the
+    // entries of rules point into, and the hash of the table, or for an ICD
+    // version that of its rules.
+    std::string table_text;
+    uint64_t hash;
+
+    void add_rules(code_trie& trie, const code_list& list, int category, bool pc, bool fixed);
+    void compile();
 
   public:
     codes(int v);
 
-    int get_version() { return version; };
+    // Compile a user-supplied code table.  Its entries are numbered in the
+    // order given, and its version is 0.  Throws std::invalid_argument for a
+    // category outside [0, CCC_FLAG) or a code the tries cannot hold.
+    explicit codes(const std::vector<code_entry>& table);
+
+    // The compiled codes for an ICD version.  Each version is built once, on
+    // first use, and shared by every later call, including calls from other
+    // threads.
+    static const codes& get(int v);
+
+    // The compiled codes for a user-supplied table.  Tables are cached by
+    // table_hash, so a table with the same entries in the same order is
+    // compiled once and shared, as long as the process lives.  If cached is
+    // given it is set to whether the table was found in the cache.
+    static std::shared_ptr<const codes> get(const std::vector<code_entry>& table,
+                                            bool* cached = nullptr);
+
+    // 64-bit FNV-1a hash of the entries of a table, in order.
+    static uint64_t table_hash(const std::vector<code_entry>& table);
+
+    int get_version() const { return version; };
+
+    // The table_hash of the entries of get_rules(), for an ICD version as for
+    // a user-supplied table.  It changes whenever the code lists do, so it
+    // identifies the classification which the tables give.
+    uint64_t get_hash() const { return hash; };
+
+    // Look up each diagnostic and procedure code once and return the bitmask
+    // of every CCC category found, see ccc_category.
+    uint16_t classify(const std::vector<std::string>& dx,
+                      const std::vector<std::string>& pc) const;
+    uint16_t classify(const std::string_view* dx, std::size_t n_dx,
+                      const std::string_view* pc, std::size_t n_pc) const;
+
+    // Single code lookups for callers which walk the codes themselves.  Bits
+    // set in found are not searched for, see code_trie::match.  With
+    // normalize, see code_trie::match_normalized.
+    uint16_t match_dx(std::string_view code, uint16_t found = 0, bool normalize = false) const {
+      return normalize ? dx_trie.match_normalized(code, found) : dx_trie.match(code, found);
+    };
+    uint16_t match_pc(std::string_view code, uint16_t found = 0, bool normalize = false) const {
+      return normalize ? pc_trie.match_normalized(code, found) : pc_trie.match(code, found);
+    };
+    uint16_t dx_reachable() const { return dx_trie.reachable(); };
+    uint16_t pc_reachable() const { return pc_trie.reachable(); };
+
+    // Classify rows [begin, end) of a block of codes laid out column by
+    // column, stride views per column, ORing the categories found into
+    // masks[begin, end).  Empty views are skipped.  The CCC_FLAG bit is not
+    // set.  Does not touch R and is safe to call from worker threads.  If
+    // stats is given the work done is counted in it, and the hits of rows
+    // [begin, end) must not have been counted already.  With normalize the
+    // codes are upper-cased and stripped of dots and whitespace as they are
+    // read, see code_trie::match_normalized.
+    void classify_columns(const std::string_view* dx, std::size_t dx_ncol,
+                          const std::string_view* pc, std::size_t pc_ncol,
+                          std::size_t stride, std::size_t begin, std::size_t end,
+                          uint16_t* masks, classify_stats* stats = nullptr,
+                          bool normalize = false) const;
+
+    // As above, but each distinct code is matched once and its mask kept in
+    // dx_memo or pc_memo, keyed by the address of its characters; see
+    // mask_memo.  Memo hits visit no trie nodes.
+    void classify_columns(const std::string_view* dx, std::size_t dx_ncol,
+                          const std::string_view* pc, std::size_t pc_ncol,
+                          std::size_t stride, std::size_t begin, std::size_t end,
+                          uint16_t* masks, mask_memo& dx_memo, mask_memo& pc_memo,
+                          classify_stats* stats = nullptr, bool normalize = false) const;
+
+    // As classify_columns, and also record which code found each category.
+    // For row i and category b, column[b * out_stride + i] is set to the
+    // 1-based column of the first code found in the category, counting the
+    // dx columns and then the pc columns, and rule[b * out_stride + i] to the
+    // 1-based number of the matching entry in get_rules().  Entries of
+    // categories not found are left as they are.  Trie nodes are not counted
+    // in stats.
+    void explain_columns(const std::string_view* dx, std::size_t dx_ncol,
+                         const std::string_view* pc, std::size_t pc_ncol,
+                         std::size_t stride, std::size_t begin, std::size_t end,
+                         uint16_t* masks, int* column, int* rule, std::size_t out_stride,
+                         classify_stats* stats = nullptr, bool normalize = false) const;
+
+    const std::vector<code_rule>& get_rules() const { return rules; };
 
     int neuromusc(      std::vector<std::string>& dx, std::vector<std::string>& pc);
     int cvd(            std::vector<std::string>& dx, std::vector<std::string>& pc);
@@ -68,35 +234,36 @@ class codes {
     int tech_dep(       std::vector<std::string>& dx, std::vector<std::string>& pc);
     int transplant(     std::vector<std::string>& dx, std::vector<std::string>& pc);
 
-    std::vector<std::string> get_dx_neuromusc()         { return dx_neuromusc; };
-    std::vector<std::string> get_dx_fixed_neuromusc()   { return dx_fixed_neuromusc; };
-    std::vector<std::string> get_dx_cvd()               { return dx_cvd; };
-    std::vector<std::string> get_dx_fixed_cvd()         { return dx_fixed_cvd; };
-    std::vector<std::string> get_dx_respiratory()       { return dx_respiratory; };
-    std::vector<std::string> get_dx_fixed_respiratory() { return dx_fixed_respiratory; };
-    std::vector<std::string> get_dx_renal()             { return dx_renal; };
-    std::vector<std::string> get_dx_gi()                { return dx_gi; };
-    std::vector<std::string> get_dx_hemato_immu()       { return dx_hemato_immu; };
-    std::vector<std::string> get_dx_metabolic()         { return dx_metabolic; };
-    std::vector<std::string> get_dx_congeni_genetic()   { return dx_congeni_genetic; };
-    std::vector<std::string> get_dx_malignancy()        { return dx_malignancy; };
-    std::vector<std::string> get_dx_neonatal()          { return dx_neonatal; };
-    std::vector<std::string> get_dx_tech_dep()          { return dx_tech_dep; };
-    std::vector<std::string> get_dx_transplant()        { return dx_transplant; };
-
-    std::vector<std::string> get_pc_neuromusc()         { return pc_neuromusc; };
-    std::vector<std::string> get_pc_cvd()               { return pc_cvd; };
-    std::vector<std::string> get_pc_respiratory()       { return pc_respiratory; };
-    std::vector<std::string> get_pc_renal()             { return pc_renal; };
-    std::vector<std::string> get_pc_gi()                { return pc_gi; };
-    std::vector<std::string> get_pc_hemato_immu()       { return pc_hemato_immu; };
-    std::vector<std::string> get_pc_metabolic()         { return pc_metabolic; };
-    std::vector<std::string> get_pc_fixed_metabolic()   { return pc_fixed_metabolic; };
-    std::vector<std::string> get_pc_malignancy()        { return pc_malignancy; };
-    std::vector<std::string> get_pc_tech_dep()          { return pc_tech_dep; };
-    std::vector<std::string> get_pc_transplant()        { return pc_transplant; };
-
-    const static Rcpp::CharacterVector col_names;
+    code_list get_dx_neuromusc() const         { return dx_neuromusc; };
+    code_list get_dx_fixed_neuromusc() const   { return dx_fixed_neuromusc; };
+    code_list get_dx_cvd() const               { return dx_cvd; };
+    code_list get_dx_fixed_cvd() const         { return dx_fixed_cvd; };
+    code_list get_dx_respiratory() const       { return dx_respiratory; };
+    code_list get_dx_fixed_respiratory() const { return dx_fixed_respiratory; };
+    code_list get_dx_renal() const             { return dx_renal; };
+    code_list get_dx_gi() const                { return dx_gi; };
+    code_list get_dx_hemato_immu() const       { return dx_hemato_immu; };
+    code_list get_dx_metabolic() const         { return dx_metabolic; };
+    code_list get_dx_congeni_genetic() const   { return dx_congeni_genetic; };
+    code_list get_dx_malignancy() const        { return dx_malignancy; };
+    code_list get_dx_neonatal() const          { return dx_neonatal; };
+    code_list get_dx_tech_dep() const          { return dx_tech_dep; };
+    code_list get_dx_transplant() const        { return dx_transplant; };
+
+    code_list get_pc_neuromusc() const         { return pc_neuromusc; };
+    code_list get_pc_cvd() const               { return pc_cvd; };
+    code_list get_pc_respiratory() const       { return pc_respiratory; };
+    code_list get_pc_renal() const             { return pc_renal; };
+    code_list get_pc_gi() const                { return pc_gi; };
+    code_list get_pc_hemato_immu() const       { return pc_hemato_immu; };
+    code_list get_pc_metabolic() const         { return pc_metabolic; };
+    code_list get_pc_fixed_metabolic() const   { return pc_fixed_metabolic; };
+    code_list get_pc_malignancy() const        { return pc_malignancy; };
+    code_list get_pc_tech_dep() const          { return pc_tech_dep; };
+    code_list get_pc_transplant() const        { return pc_transplant; };
+
+    // names of the twelve CCC categories, in bit order
+    static const char* const col_names[CCC_FLAG];
 };
 
 #endif
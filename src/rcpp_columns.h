@@ -0,0 +1,66 @@
+#include <string_view>
+#include <vector>
+#include <Rcpp.h>
+
+#ifndef RCPP_COLUMNS_H
+#define RCPP_COLUMNS_H
+
+// One column of codes, read in place: a character vector, or a factor whose
+// codes index its levels.
+struct code_column {
+  const SEXP* strings;  // the cells, or the levels of a factor
+  const int* factor;    // the codes of a factor, nullptr for a character vector
+  R_xlen_t n_levels;
+};
+
+// The columns of a list of character vectors and factors of nrow codes each.
+inline std::vector<code_column> list_columns(const Rcpp::List& l, R_xlen_t nrow)
+{
+  std::vector<code_column> cols(l.size());
+  for (R_xlen_t j = 0; j < l.size(); ++j) {
+    SEXP col = l[j];
+    if (XLENGTH(col) != nrow) {
+      Rcpp::stop("All code columns must have the same number of rows.");
+    }
+    if (Rf_isFactor(col)) {
+      SEXP levels = Rf_getAttrib(col, R_LevelsSymbol);
+      cols[j] = code_column{STRING_PTR_RO(levels), INTEGER(col), XLENGTH(levels)};
+    } else if (TYPEOF(col) == STRSXP) {
+      cols[j] = code_column{STRING_PTR_RO(col), nullptr, 0};
+    } else {
+      Rcpp::stop("Code columns must be character vectors or factors.");
+    }
+  }
+  return cols;
+}
+
+// Views of the codes of rows [begin, end) of cols, column by column, with NA
+// cells left empty.
+inline void fill_views(std::vector<std::string_view>& views, const std::vector<code_column>& cols,
+                       R_xlen_t begin, R_xlen_t end)
+{
+  const R_xlen_t len = end - begin;
+  views.resize(len * cols.size());
+  for (std::size_t j = 0; j < cols.size(); ++j) {
+    std::string_view* out = views.data() + j * len;
+    for (R_xlen_t i = 0; i < len; ++i) {
+      SEXP cell = NA_STRING;
+      if (!cols[j].factor) {
+        cell = cols[j].strings[begin + i];
+      } else {
+        // NA_INTEGER is negative
+        const int c = cols[j].factor[begin + i];
+        if (c > 0 && c <= cols[j].n_levels) {
+          cell = cols[j].strings[c - 1];
+        }
+      }
+      if (cell == NA_STRING) {
+        out[i] = std::string_view();
+      } else {
+        out[i] = std::string_view(CHAR(cell), LENGTH(cell));
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <Rcpp.h>
+
+#ifndef RCPP_GROUPS_H
+#define RCPP_GROUPS_H
+
+// Group index of every row: a new group starts wherever the id differs from
+// the id of the previous row when sorted, otherwise rows are grouped by a hash
+// of the id.  first holds the first row of each group.
+template <typename Key, typename KeyOf>
+void group_rows(R_xlen_t n, bool sorted, KeyOf key_of,
+                std::vector<R_xlen_t>& group, std::vector<R_xlen_t>& first)
+{
+  group.resize(n);
+
+  if (sorted) {
+    for (R_xlen_t i = 0; i < n; ++i) {
+      if (i == 0 || !(key_of(i) == key_of(i - 1))) {
+        first.push_back(i);
+      }
+      group[i] = first.size() - 1;
+    }
+    return;
+  }
+
+  std::unordered_map<Key, R_xlen_t> index;
+  for (R_xlen_t i = 0; i < n; ++i) {
+    auto it = index.emplace(key_of(i), first.size());
+    if (it.second) {
+      first.push_back(i);
+    }
+    group[i] = it.first->second;
+  }
+}
+
+// A double as a hash key, with -0 equal to 0 and all NaNs, including NA,
+// equal to each other.
+inline uint64_t double_key(double x)
+{
+  if (x != x) {
+    return UINT64_C(0x7ff8000000000000);
+  }
+  if (x == 0) {
+    x = 0;
+  }
+  uint64_t key;
+  std::memcpy(&key, &x, sizeof key);
+  return key;
+}
+
+// Group the rows of an R vector of ids, see group_rows.  Factors are grouped
+// by their codes.
+inline void group_ids(SEXP id, bool sorted, std::vector<R_xlen_t>& group,
+                      std::vector<R_xlen_t>& first)
+{
+  const R_xlen_t n = XLENGTH(id);
+
+  switch (TYPEOF(id)) {
+    case INTSXP:
+    case LGLSXP: {
+      const int* x = TYPEOF(id) == INTSXP ? INTEGER(id) : LOGICAL(id);
+      group_rows<int>(n, sorted, [x](R_xlen_t i) { return x[i]; }, group, first);
+      break;
+    }
+    case REALSXP: {
+      const double* x = REAL(id);
+      group_rows<uint64_t>(n, sorted, [x](R_xlen_t i) { return double_key(x[i]); }, group, first);
+      break;
+    }
+    case STRSXP: {
+      const SEXP* x = STRING_PTR_RO(id);
+      group_rows<SEXP>(n, sorted, [x](R_xlen_t i) { return x[i]; }, group, first);
+      break;
+    }
+    default:
+      Rcpp::stop("id must be an integer, numeric, character or factor vector.");
+  }
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include <Rcpp.h>
+#include "pccc.h"
+
+#ifndef RCPP_NAMES_H
+#define RCPP_NAMES_H
+
+// The names of the twelve CCC categories, followed by "ccc_flag" if with_flag,
+// as used for the columns of the results.
+inline Rcpp::CharacterVector category_names(bool with_flag = false)
+{
+  Rcpp::CharacterVector names(CCC_FLAG + (with_flag ? 1 : 0));
+  for (int j = 0; j < CCC_FLAG; ++j) {
+    names[j] = codes::col_names[j];
+  }
+  if (with_flag) {
+    names[CCC_FLAG] = "ccc_flag";
+  }
+  return names;
+}
+
+#endif
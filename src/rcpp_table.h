@@ -0,0 +1,36 @@
+#include <memory>
+#include <Rcpp.h>
+#include "pccc.h"
+
+#ifndef RCPP_TABLE_H
+#define RCPP_TABLE_H
+
+// The handles returned by ccc_table() are external pointers of class
+// "pccc_table" to one of these, sharing the compiled table with the cache in
+// codes::get.
+typedef std::shared_ptr<const codes> code_table;
+
+inline bool is_code_table(SEXP x)
+{
+  return TYPEOF(x) == EXTPTRSXP && Rf_inherits(x, "pccc_table");
+}
+
+inline const codes& table_codes(SEXP x)
+{
+  const code_table* table = static_cast<const code_table*>(R_ExternalPtrAddr(x));
+  if (!table) {
+    Rcpp::stop("The code table is no longer loaded, as happens when it is saved and restored.  Call ccc_table() again.");
+  }
+  return **table;
+}
+
+// The compiled codes for icdv, an ICD version or a handle from ccc_table().
+inline const codes& codes_for(SEXP icdv)
+{
+  if (is_code_table(icdv)) {
+    return table_codes(icdv);
+  }
+  return codes::get(Rcpp::as<int>(icdv));
+}
+
+#endif
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+#include "row_bitmap.h"
+
+bool row_bitmap::chunk::contains(uint16_t low) const
+{
+  if (is_array()) {
+    return std::binary_search(array.begin(), array.end(), low);
+  }
+  return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+void row_bitmap::chunk::to_bits(uint64_t* out) const
+{
+  if (is_array()) {
+    std::fill(out, out + words, 0);
+    for (uint16_t low : array) {
+      out[low >> 6] |= UINT64_C(1) << (low & 63);
+    }
+  } else {
+    std::copy(bits.begin(), bits.end(), out);
+  }
+}
+
+// Set the chunk to the rows of a bitmap, as an array if there are few enough.
+void row_bitmap::chunk::from_bits(const uint64_t* in)
+{
+  n = 0;
+  for (std::size_t w = 0; w < words; ++w) {
+    n += static_cast<uint32_t>(std::bitset<64>(in[w]).count());
+  }
+
+  array.clear();
+  bits.clear();
+  if (n > array_max) {
+    bits.assign(in, in + words);
+    return;
+  }
+  array.reserve(n);
+  for (std::size_t w = 0; w < words; ++w) {
+    for (uint64_t x = in[w]; x; x &= x - 1) {
+      array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(x)));
+    }
+  }
+}
+
+row_bitmap::chunk& row_bitmap::append_chunk(uint16_t key)
+{
+  chunks.push_back(chunk{key, 0, {}, {}});
+  return chunks.back();
+}
+
+void row_bitmap::push_back(uint32_t row)
+{
+  const uint16_t key = static_cast<uint16_t>(row >> 16);
+  const uint16_t low = static_cast<uint16_t>(row);
+
+  chunk& c = chunks.empty() || chunks.back().key != key ? append_chunk(key) : chunks.back();
+
+  if (c.is_array()) {
+    if (c.n > 0 && c.array.back() == low) {
+      return;
+    }
+    if (c.n < array_max) {
+      c.array.push_back(low);
+      ++c.n;
+      return;
+    }
+    c.bits.resize(words);
+    c.to_bits(c.bits.data());
+    c.array.clear();
+    c.array.shrink_to_fit();
+  }
+
+  uint64_t& w = c.bits[low >> 6];
+  const uint64_t bit = UINT64_C(1) << (low & 63);
+  if (!(w & bit)) {
+    w |= bit;
+    ++c.n;
+  }
+}
+
+bool row_bitmap::contains(uint32_t row) const
+{
+  const uint16_t key = static_cast<uint16_t>(row >> 16);
+  auto c = std::lower_bound(chunks.begin(), chunks.end(), key,
+                            [](const chunk& a, uint16_t k) { return a.key < k; });
+  return c != chunks.end() && c->key == key && c->contains(static_cast<uint16_t>(row));
+}
+
+std::size_t row_bitmap::size() const
+{
+  std::size_t n = 0;
+  for (const chunk& c : chunks) {
+    n += c.n;
+  }
+  return n;
+}
+
+std::size_t row_bitmap::bytes() const
+{
+  std::size_t n = 0;
+  for (const chunk& c : chunks) {
+    n += sizeof(chunk) + c.array.size() * sizeof(uint16_t) + c.bits.size() * sizeof(uint64_t);
+  }
+  return n;
+}
+
+std::vector<uint32_t> row_bitmap::rows() const
+{
+  std::vector<uint32_t> out;
+  out.reserve(size());
+  for (const chunk& c : chunks) {
+    const uint32_t high = static_cast<uint32_t>(c.key) << 16;
+    if (c.is_array()) {
+      for (uint16_t low : c.array) {
+        out.push_back(high | low);
+      }
+    } else {
+      for (std::size_t w = 0; w < words; ++w) {
+        for (uint64_t x = c.bits[w]; x; x &= x - 1) {
+          out.push_back(high | static_cast<uint32_t>(w * 64 + __builtin_ctzll(x)));
+        }
+      }
+    }
+  }
+  return out;
+}
+
+row_bitmap row_bitmap::and_of(const row_bitmap& a, const row_bitmap& b)
+{
+  row_bitmap out;
+  std::vector<uint64_t> buf(words);
+  auto i = a.chunks.begin();
+  auto j = b.chunks.begin();
+
+  while (i != a.chunks.end() && j != b.chunks.end()) {
+    if (i->key < j->key) {
+      ++i;
+      continue;
+    }
+    if (j->key < i->key) {
+      ++j;
+      continue;
+    }
+
+    chunk c{i->key, 0, {}, {}};
+    if (i->is_array() && j->is_array()) {
+      std::set_intersection(i->array.begin(), i->array.end(), j->array.begin(), j->array.end(),
+                            std::back_inserter(c.array));
+      c.n = static_cast<uint32_t>(c.array.size());
+    } else if (i->is_array() || j->is_array()) {
+      // look up the rows of the array in the other chunk
+      const chunk& small = i->is_array() ? *i : *j;
+      const chunk& other = i->is_array() ? *j : *i;
+      for (uint16_t low : small.array) {
+        if (other.contains(low)) {
+          c.array.push_back(low);
+        }
+      }
+      c.n = static_cast<uint32_t>(c.array.size());
+    } else {
+      for (std::size_t w = 0; w < words; ++w) {
+        buf[w] = i->bits[w] & j->bits[w];
+      }
+      c.from_bits(buf.data());
+    }
+    if (c.n) {
+      out.chunks.push_back(std::move(c));
+    }
+    ++i;
+    ++j;
+  }
+
+  return out;
+}
+
+row_bitmap row_bitmap::or_of(const row_bitmap& a, const row_bitmap& b)
+{
+  row_bitmap out;
+  std::vector<uint64_t> buf(words);
+  std::vector<uint64_t> other(words);
+  auto i = a.chunks.begin();
+  auto j = b.chunks.begin();
+
+  while (i != a.chunks.end() || j != b.chunks.end()) {
+    if (j == b.chunks.end() || (i != a.chunks.end() && i->key < j->key)) {
+      out.chunks.push_back(*i++);
+      continue;
+    }
+    if (i == a.chunks.end() || j->key < i->key) {
+      out.chunks.push_back(*j++);
+      continue;
+    }
+
+    chunk c{i->key, 0, {}, {}};
+    if (i->is_array() && j->is_array() && i->n + j->n <= array_max) {
+      std::set_union(i->array.begin(), i->array.end(), j->array.begin(), j->array.end(),
+                     std::back_inserter(c.array));
+      c.n = static_cast<uint32_t>(c.array.size());
+    } else {
+      i->to_bits(buf.data());
+      j->to_bits(other.data());
+      for (std::size_t w = 0; w < words; ++w) {
+        buf[w] |= other[w];
+      }
+      c.from_bits(buf.data());
+    }
+    out.chunks.push_back(std::move(c));
+    ++i;
+    ++j;
+  }
+
+  return out;
+}
+
+row_bitmap row_bitmap::and_not(const row_bitmap& a, const row_bitmap& b)
+{
+  row_bitmap out;
+  std::vector<uint64_t> buf(words);
+  auto j = b.chunks.begin();
+
+  for (const chunk& x : a.chunks) {
+    while (j != b.chunks.end() && j->key < x.key) {
+      ++j;
+    }
+    if (j == b.chunks.end() || j->key != x.key) {
+      out.chunks.push_back(x);
+      continue;
+    }
+
+    chunk c{x.key, 0, {}, {}};
+    if (x.is_array() && j->is_array()) {
+      std::set_difference(x.array.begin(), x.array.end(), j->array.begin(), j->array.end(),
+                          std::back_inserter(c.array));
+      c.n = static_cast<uint32_t>(c.array.size());
+    } else if (x.is_array()) {
+      for (uint16_t low : x.array) {
+        if (!j->contains(low)) {
+          c.array.push_back(low);
+        }
+      }
+      c.n = static_cast<uint32_t>(c.array.size());
+    } else {
+      std::copy(x.bits.begin(), x.bits.end(), buf.begin());
+      if (j->is_array()) {
+        for (uint16_t low : j->array) {
+          buf[low >> 6] &= ~(UINT64_C(1) << (low & 63));
+        }
+      } else {
+        for (std::size_t w = 0; w < words; ++w) {
+          buf[w] &= ~j->bits[w];
+        }
+      }
+      c.from_bits(buf.data());
+    }
+    if (c.n) {
+      out.chunks.push_back(std::move(c));
+    }
+  }
+
+  return out;
+}
+
+// The number of chunks, then for each its key, row count and rows, as an
+// array or a bitmap according to the count.
+void row_bitmap::write(std::FILE* out) const
+{
+  const uint32_t n_chunks = static_cast<uint32_t>(chunks.size());
+  write_values(out, &n_chunks, 1);
+  for (const chunk& c : chunks) {
+    write_values(out, &c.key, 1);
+    write_values(out, &c.n, 1);
+    if (c.is_array()) {
+      write_values(out, c.array.data(), c.array.size());
+    } else {
+      write_values(out, c.bits.data(), c.bits.size());
+    }
+  }
+}
+
+row_bitmap row_bitmap::read(std::FILE* in)
+{
+  row_bitmap out;
+  uint32_t n_chunks = 0;
+  read_values(in, &n_chunks, 1);
+  if (n_chunks > 65536) {
+    throw std::runtime_error("The index file is not a valid index.");
+  }
+
+  out.chunks.resize(n_chunks);
+  for (uint32_t k = 0; k < n_chunks; ++k) {
+    chunk& c = out.chunks[k];
+    read_values(in, &c.key, 1);
+    read_values(in, &c.n, 1);
+    if (c.n == 0 || c.n > 65536 || (k > 0 && c.key <= out.chunks[k - 1].key)) {
+      throw std::runtime_error("The index file is not a valid index.");
+    }
+    if (c.is_array()) {
+      c.array.resize(c.n);
+      read_values(in, c.array.data(), c.n);
+    } else {
+      c.bits.resize(words);
+      read_values(in, c.bits.data(), words);
+    }
+  }
+
+  return out;
+}
@@ -0,0 +1,84 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#ifndef ROW_BITMAP_H
+#define ROW_BITMAP_H
+
+// Write or read n values of index files in the byte order of this machine.
+template <typename T>
+inline void write_values(std::FILE* out, const T* x, std::size_t n)
+{
+  if (std::fwrite(x, sizeof(T), n, out) != n) {
+    throw std::runtime_error("Error writing the index file.");
+  }
+}
+
+template <typename T>
+inline void read_values(std::FILE* in, T* x, std::size_t n)
+{
+  if (std::fread(x, sizeof(T), n, in) != n) {
+    throw std::runtime_error("The index file is truncated.");
+  }
+}
+
+// A compressed set of row numbers, in the manner of roaring bitmaps.  Rows are
+// split by their high 16 bits into chunks, kept in order of those bits, and
+// each chunk holds the low 16 bits of its rows as a sorted array while it has
+// at most array_max rows, or else as a bitmap of 65536 bits.  A sparse set
+// takes about 2 bytes per row and a dense one 1 bit per row, and the set
+// operations work a chunk at a time, on arrays or on 64-bit words.
+class row_bitmap {
+  public:
+    static const uint32_t array_max = 4096;
+
+  private:
+    static const std::size_t words = 65536 / 64;
+
+    struct chunk {
+      uint16_t key;                 // the high 16 bits of the rows
+      uint32_t n;                   // rows in the chunk
+      std::vector<uint16_t> array;  // the low 16 bits, if n <= array_max
+      std::vector<uint64_t> bits;   // words bits, otherwise
+
+      bool is_array() const { return n <= array_max; };
+      bool contains(uint16_t low) const;
+      void to_bits(uint64_t* out) const;
+      void from_bits(const uint64_t* in);
+    };
+
+    std::vector<chunk> chunks;
+
+    chunk& append_chunk(uint16_t key);
+
+  public:
+    // Add row, which must be greater than every row already in the set, as
+    // when the rows of a dataset are indexed in order.  Adding the last row
+    // again does nothing.
+    void push_back(uint32_t row);
+
+    bool contains(uint32_t row) const;
+    bool empty() const { return chunks.empty(); };
+    std::size_t size() const;
+
+    // bytes taken by the rows, for reporting
+    std::size_t bytes() const;
+
+    // the rows of the set, in increasing order
+    std::vector<uint32_t> rows() const;
+
+    // the set operations: a AND b, a OR b and a AND NOT b
+    static row_bitmap and_of(const row_bitmap& a, const row_bitmap& b);
+    static row_bitmap or_of(const row_bitmap& a, const row_bitmap& b);
+    static row_bitmap and_not(const row_bitmap& a, const row_bitmap& b);
+
+    // Write the set to, or read it from, a binary file in the byte order of
+    // this machine.  Throws std::runtime_error on a read or write error or a
+    // malformed set.
+    void write(std::FILE* out) const;
+    static row_bitmap read(std::FILE* in);
+};
+
+#endif
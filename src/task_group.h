@@ -0,0 +1,210 @@
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef TASK_GROUP_H
+#define TASK_GROUP_H
+
+// A set of tasks run on their own std::threads, for work done once per call.
+// wait() joins them and rethrows the first exception thrown by any task.
+// Tasks must not call the R API; they only read and write memory which the
+// main thread has prepared.
+class task_group {
+  private:
+    std::vector<std::thread> threads;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+  public:
+    task_group() {};
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() {
+      for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+      }
+    };
+
+    template <typename F>
+    void run(F fn) {
+      threads.emplace_back([this, fn]() {
+        try {
+          fn();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      });
+    };
+
+    void wait() {
+      for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+      }
+      threads.clear();
+      if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+      }
+    };
+};
+
+// Start of the k-th of n_parts contiguous, near equal parts of [0, n).
+inline std::size_t part_begin(std::size_t n, std::size_t n_parts, std::size_t k)
+{
+  return n / n_parts * k + (k < n % n_parts ? k : n % n_parts);
+}
+
+// n_threads worker threads started once and given one job after another, for
+// work done a batch at a time: start(fn) calls fn(k) on the k-th worker for
+// each k and returns, so that the calling thread can prepare the next batch,
+// and wait() waits for every worker to finish the job and rethrows the first
+// exception thrown by any of them.  With one thread there are no workers and
+// start(fn) calls fn(0) itself.  The same rules as for task_group apply to
+// the jobs.
+class thread_pool {
+  private:
+    int n_threads;
+    std::vector<std::thread> threads;
+    std::function<void(int)> job;
+    uint64_t generation;  // the number of jobs started
+    int pending;          // workers still running the current job
+    bool stopping;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+
+    void work(int k) {
+      uint64_t seen = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          started.wait(lock, [this, seen]() { return stopping || generation != seen; });
+          if (stopping) {
+            return;
+          }
+          seen = generation;
+        }
+        try {
+          job(k);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+          finished.notify_one();
+        }
+      }
+    };
+
+    void wait_for_workers() {
+      std::unique_lock<std::mutex> lock(mutex);
+      finished.wait(lock, [this]() { return pending == 0; });
+    };
+
+  public:
+    explicit thread_pool(int n_threads)
+      : n_threads(n_threads), generation(0), pending(0), stopping(false) {
+      if (n_threads > 1) {
+        for (int k = 0; k < n_threads; ++k) {
+          threads.emplace_back([this, k]() { work(k); });
+        }
+      }
+    };
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // finishes the current job, if an error on the calling thread left one
+    // running, before the workers are stopped
+    ~thread_pool() {
+      wait_for_workers();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      started.notify_all();
+      for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+      }
+    };
+
+    int size() const { return n_threads; };
+
+    template <typename F>
+    void start(F fn) {
+      if (threads.empty()) {
+        fn(0);
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = fn;
+        pending = n_threads;
+        ++generation;
+      }
+      started.notify_all();
+    };
+
+    // start fn(k, begin, end) on the k-th of size() contiguous parts of
+    // [0, n), skipping empty parts
+    template <typename F>
+    void start_parts(std::size_t n, F fn) {
+      const int parts = n_threads;
+      start([n, parts, fn](int k) {
+        const std::size_t begin = part_begin(n, parts, k);
+        const std::size_t end = part_begin(n, parts, k + 1);
+        if (begin < end) {
+          fn(k, begin, end);
+        }
+      });
+    };
+
+    void wait() {
+      if (threads.empty()) {
+        return;
+      }
+      wait_for_workers();
+      if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+      }
+    };
+};
+
+// Call fn(begin, end) on n_threads contiguous parts of [0, n), each on its own
+// thread, and wait for all of them.  With one thread fn(0, n) is called
+// directly.
+template <typename F>
+void parallel_for(std::size_t n, int n_threads, F fn)
+{
+  if (n_threads <= 1 || n < 2) {
+    fn(std::size_t(0), n);
+    return;
+  }
+
+  task_group tasks;
+  for (int k = 0; k < n_threads; ++k) {
+    std::size_t begin = part_begin(n, n_threads, k);
+    std::size_t end = part_begin(n, n_threads, k + 1);
+    if (begin < end) {
+      tasks.run([&fn, begin, end]() { fn(begin, end); });
+    }
+  }
+  tasks.wait();
+}
+
+#endif